@@ -0,0 +1,958 @@
+﻿#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <chrono>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <atomic>
+#include <random>
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <future>
+#include "lexical.h"
+
+using namespace std;
+
+// Which FSM code the scanner was built with; build once with and once without `LEXICAL_DIRECT_CODED` to compare them
+#ifdef LEXICAL_DIRECT_CODED
+static const char* const scannerBuild = "direct-coded (directScanner.h)";
+#else
+static const char* const scannerBuild = "table-driven";
+#endif
+
+// |-------------------------------------------------------------------------------------------------------------|
+// |                                            Allocation Counter                                               |
+// |-------------------------------------------------------------------------------------------------------------|
+
+// Every heap allocation of the program goes through these replacements, so a run can be charged with the allocations it made.
+// The whole family is replaced over `malloc`/`free`, so every `delete` frees a block its matching `new` allocated.
+static atomic<size_t> allocationCount{ 0 };
+
+static void* countedAllocation(size_t size) noexcept
+{
+    allocationCount.fetch_add(1, memory_order_relaxed);
+    return malloc(size ? size : 1);
+}
+
+void* operator new(size_t size)
+{
+    if (void* block = countedAllocation(size))
+        return block;
+    throw bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    if (void* block = countedAllocation(size))
+        return block;
+    throw bad_alloc();
+}
+
+void* operator new(size_t size, const nothrow_t&) noexcept { return countedAllocation(size); }
+void* operator new[](size_t size, const nothrow_t&) noexcept { return countedAllocation(size); }
+
+// g++ 12 inlines `std::allocator` into the callers and pairs its `::operator new` with the `free` below without
+// seeing that `operator new` is replaced over `malloc` above; the pairs match, so -Wmismatched-new-delete is a false positive here
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void* block) noexcept { free(block); }
+void operator delete[](void* block) noexcept { free(block); }
+void operator delete(void* block, size_t) noexcept { free(block); }
+void operator delete[](void* block, size_t) noexcept { free(block); }
+void operator delete(void* block, const nothrow_t&) noexcept { free(block); }
+void operator delete[](void* block, const nothrow_t&) noexcept { free(block); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+// |-------------------------------------------------------------------------------------------------------------|
+// |                                         Synthetic Source Generator                                          |
+// |-------------------------------------------------------------------------------------------------------------|
+
+/* <summary>
+The `SourceGenerator` class writes synthetic lexer input of a given size and token mix. The output only depends on the profile, the size and the seed, so every run of the benchmark lexes exactly the same bytes.
+
+Logic:
+1. A profile gives the relative weights of keywords, identifiers, numbers, operators and punctuation, and the range of tokens per line:
+   - `mixed`: a code-like mix, 4-12 tokens per line.
+   - `identifiers`: mostly identifiers (`_name` style, which the identifier machine requires) and keywords.
+   - `numbers`: mostly numbers, with fractions and signed exponents (`3.413E-13`, `.12`, `6E+4`).
+   - `operators`: mostly one- and two-character operators and punctuation.
+   - `longlines`: the mixed token set with 200-400 tokens per line.
+   - `shortlines`: the mixed token set with 1-2 tokens per line, indented.
+2. Tokens are separated by one space; a line ends with `;` or a newline alone, so delimiters of every kind appear in the input.
+3. Generation stops at the first line end at or after the requested size.
+</summary>*/
+class SourceGenerator
+{
+public:
+    struct Profile
+    {
+        const char* name;
+        int keywordWeight, identifierWeight, numberWeight, operatorWeight, punctuationWeight;
+        int minTokensPerLine, maxTokensPerLine;
+    };
+
+    static const vector<Profile>& profiles()
+    {
+        static const vector<Profile> all =
+        {
+            { "mixed",       10, 35, 15, 25, 15,   4,  12 },
+            { "identifiers", 20, 75,  0,  5,  0,   4,  12 },
+            { "numbers",      0,  5, 80, 10,  5,   4,  12 },
+            { "operators",    0, 10,  5, 60, 25,   4,  12 },
+            { "longlines",   10, 35, 15, 25, 15, 200, 400 },
+            { "shortlines",  10, 35, 15, 25, 15,   1,   2 },
+        };
+        return all;
+    }
+
+    static const Profile* find(const string& name)
+    {
+        for (const Profile& profile : profiles())
+            if (name == profile.name)
+                return &profile;
+        return nullptr;
+    }
+
+    static string generate(const Profile& profile, size_t bytes, uint32_t seed = 12345)
+    {
+        static const char* const operators[] = { "+", "-", "*", "/", "%", "=", "==", "!=", "<>", "<<", ">>", "++", "--", "+=", "-=", "*=", "%=", "&&", "||", "=>", "=<", ":", "::" };
+        static const char* const punctuations[] = { "{", "}", "[", "]", "<", ">", "(", ")", "," };
+        const size_t keywordCount = sizeof(Lexical::keywords) / sizeof(Lexical::keywords[0]);
+
+        mt19937 random(seed);
+        auto pick = [&random](size_t count) { return static_cast<size_t>(random() % count); };
+        const int totalWeight = profile.keywordWeight + profile.identifierWeight + profile.numberWeight + profile.operatorWeight + profile.punctuationWeight;
+
+        string text;
+        text.reserve(bytes + 4096);
+        while (text.size() < bytes)
+        {
+            if (profile.maxTokensPerLine <= 2)
+                text.append(4 * pick(4), ' ');
+            int lineTokens = profile.minTokensPerLine + static_cast<int>(pick(profile.maxTokensPerLine - profile.minTokensPerLine + 1));
+            for (int t = 0; t < lineTokens; ++t)
+            {
+                if (t > 0)
+                    text += ' ';
+                int roll = static_cast<int>(pick(totalWeight));
+                if ((roll -= profile.keywordWeight) < 0)
+                {
+                    text += Lexical::keywords[pick(keywordCount)];
+                }
+                else if ((roll -= profile.identifierWeight) < 0)
+                {
+                    text += '_';
+                    size_t length = 1 + pick(10);
+                    for (size_t k = 0; k < length; ++k)
+                        text += k > 0 && pick(4) == 0 ? static_cast<char>('0' + pick(10)) : static_cast<char>('a' + pick(26));
+                }
+                else if ((roll -= profile.numberWeight) < 0)
+                {
+                    size_t form = pick(4);
+                    if (form != 3)
+                        text += to_string(random() % 100000);
+                    if (form >= 1)
+                        text += '.' + to_string(random() % 10000);
+                    if (form >= 2)
+                    {
+                        text += pick(2) ? "E+" : "E-";
+                        text += to_string(1 + pick(30));
+                    }
+                }
+                else if ((roll -= profile.operatorWeight) < 0)
+                {
+                    text += operators[pick(sizeof(operators) / sizeof(operators[0]))];
+                }
+                else
+                {
+                    text += punctuations[pick(sizeof(punctuations) / sizeof(punctuations[0]))];
+                }
+            }
+            text += pick(2) ? ";\n" : "\n";
+        }
+        return text;
+    }
+};
+
+// |-------------------------------------------------------------------------------------------------------------|
+// |                                            Throughput Suite                                                 |
+// |-------------------------------------------------------------------------------------------------------------|
+
+/* <summary>
+The `ThroughputSuite` class measures `PerformLexical` end to end on generated sources, once per input mode and scanner engine.
+
+Logic:
+1. Each profile is generated (see `SourceGenerator`) and written to a scratch file, which is removed afterwards.
+2. Every configuration lexes the file with a fresh `Lexical` at `Verbosity::Quiet`: `stream`, `mapped`, `merged` (mapped input with `ScanEngine::MergedDFA`), `metrics` (`mapped` with `setMetrics` on, the cost of the statistics), `spec` (mapped input with `ScanEngine::Specification` and `lexer_spec.txt`, skipped if that file cannot be loaded) and `parallel` write no report files, so they measure scanning; `reports` is `mapped` with `tokenLex.txt`, `symbolTable.txt` and `error.txt` written to scratch files, the cost of a normal run. Loading the specification is not timed.
+3. One untimed warm-up run loads the file into the page cache, then `rounds` runs are timed. The best and the median time are reported, with MB/s and million tokens/s of the best run, and the heap allocations per token of the last run. `allocs/tok` counts only calls to the replaced `operator new` / `operator new[]` (all forms); memory taken directly with `malloc`, `mmap` or by the C library is not counted.
+4. All configurations with the same engine must produce the same number of tokens; otherwise the suite fails. (`MergedDFA` and `Specification` take the longest match, so their counts differ from the cascade's on glued input.)
+</summary>*/
+class ThroughputSuite
+{
+private:
+    struct Configuration
+    {
+        const char* name;
+        Lexical::InputMode mode;
+        Lexical::ScanEngine engine;
+        bool reports;
+        bool metrics;
+    };
+
+    const string inputName = "lexer_bench_input.txt";
+    const string tokenName = "lexer_bench_tokenLex.txt";
+    const string symbolName = "lexer_bench_symbolTable.txt";
+    const string errorName = "lexer_bench_error.txt";
+    const string specName = "lexer_spec.txt";
+
+    static const vector<Configuration>& configurations()
+    {
+        static const vector<Configuration> all =
+        {
+            { "stream",   Lexical::InputMode::Stream,   Lexical::ScanEngine::Cascade,   false, false },
+            { "mapped",   Lexical::InputMode::Mapped,   Lexical::ScanEngine::Cascade,   false, false },
+            { "metrics",  Lexical::InputMode::Mapped,   Lexical::ScanEngine::Cascade,   false, true  },
+            { "merged",   Lexical::InputMode::Mapped,   Lexical::ScanEngine::MergedDFA, false, false },
+            { "spec",     Lexical::InputMode::Mapped,   Lexical::ScanEngine::Specification, false, false },
+            { "parallel", Lexical::InputMode::Parallel, Lexical::ScanEngine::Cascade,   false, false },
+            { "reports",  Lexical::InputMode::Mapped,   Lexical::ScanEngine::Cascade,   true,  false },
+        };
+        return all;
+    }
+
+    // One `PerformLexical` run; returns the number of tokens, or -1 on failure
+    long long runOnce(const Configuration& configuration, double& seconds, size_t& allocations)
+    {
+        Lexical lexical;
+        lexical.setVerbosity(Verbosity::Quiet);
+        lexical.setInputMode(configuration.mode);
+        if (configuration.engine == Lexical::ScanEngine::Specification && !lexical.loadLexerSpec(specName))
+            return -1;
+        lexical.setScanEngine(configuration.engine);
+        lexical.setArtifact(Artifact::TokenFile, configuration.reports);
+        lexical.setArtifact(Artifact::SymbolTable, configuration.reports);
+        lexical.setArtifact(Artifact::ErrorFile, configuration.reports);
+        lexical.setMetrics(configuration.metrics);
+
+        size_t allocationsBefore = allocationCount.load(memory_order_relaxed);
+        auto start = chrono::steady_clock::now();
+        int status = lexical.PerformLexical(inputName, tokenName, symbolName, errorName);
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        allocations = allocationCount.load(memory_order_relaxed) - allocationsBefore;
+        return status == 0 ? static_cast<long long>(lexical.getTokens().size()) : -1;
+    }
+
+public:
+    int run(const SourceGenerator::Profile& profile, size_t bytes, int rounds)
+    {
+        string text = SourceGenerator::generate(profile, bytes);
+        {
+            ofstream output(inputName, ios::binary);
+            output.write(text.data(), static_cast<streamsize>(text.size()));
+            if (!output)
+            {
+                cerr << "Error: Could not write " << inputName << "\n";
+                return 1;
+            }
+        }
+        const double megabytes = static_cast<double>(text.size()) / (1024.0 * 1024.0);
+
+        cout << "Profile " << profile.name << " (" << fixed << setprecision(2) << megabytes << " MB, best of " << rounds << " rounds)\n";
+        cout << left << setw(12) << "config" << right << setw(12) << "best ms" << setw(12) << "median ms"
+            << setw(10) << "MB/s" << setw(10) << "Mtok/s" << setw(12) << "allocs/tok" << setw(12) << "tokens" << "\n";
+
+        int result = 0;
+        map<Lexical::ScanEngine, long long> expectedTokens;
+        for (const Configuration& configuration : configurations())
+        {
+            if (configuration.engine == Lexical::ScanEngine::Specification && !ifstream(specName).is_open())
+                continue;
+
+            double seconds = 0.0;
+            size_t allocations = 0;
+            long long tokens = runOnce(configuration, seconds, allocations);
+
+            vector<double> times;
+            for (int r = 0; r < rounds && tokens >= 0; ++r)
+            {
+                tokens = runOnce(configuration, seconds, allocations);
+                times.push_back(seconds);
+            }
+            if (tokens < 0)
+            {
+                cerr << "Error: " << configuration.name << " run failed\n";
+                result = 1;
+                continue;
+            }
+            sort(times.begin(), times.end());
+            double best = times.front();
+            double median = times[times.size() / 2];
+
+            cout << left << setw(12) << configuration.name << right << fixed
+                << setw(12) << setprecision(3) << best * 1000.0
+                << setw(12) << median * 1000.0
+                << setw(10) << setprecision(1) << (best > 0 ? megabytes / best : 0.0)
+                << setw(10) << setprecision(2) << (best > 0 ? tokens / best / 1e6 : 0.0)
+                << setw(12) << setprecision(3) << (tokens > 0 ? static_cast<double>(allocations) / tokens : 0.0)
+                << setw(12) << tokens << "\n";
+
+            auto expected = expectedTokens.emplace(configuration.engine, tokens).first;
+            if (tokens != expected->second)
+                result = 1;
+        }
+
+        remove(inputName.c_str());
+        remove(tokenName.c_str());
+        remove(symbolName.c_str());
+        remove(errorName.c_str());
+        if (result != 0)
+            cerr << "Error: configurations disagree on profile " << profile.name << "\n";
+        return result;
+    }
+};
+
+// |-------------------------------------------------------------------------------------------------------------|
+// |                                        Intern Table Contention                                              |
+// |-------------------------------------------------------------------------------------------------------------|
+
+/* <summary>
+The `InternContention` class measures how interning scales when many threads intern the same lexemes at once, as when several files (or the chunks of one file) are lexed in parallel.
+
+Logic:
+1. The lexemes come from a generated `identifiers` source (see `SourceGenerator`), split at whitespace. Every thread interns all of them, starting at a different position, so the threads hit the same texts at different times.
+2. For each thread count (1, 2, 4, ... up to the maximum) the threads run on a `ThreadPool` and three tables are compared:
+   - `private`: one `InternTable` per thread, what every `Lexical` instance has on its own; no sharing, every thread stores its own copy of every text.
+   - `locked`: one `InternTable` for all threads behind a `std::mutex`.
+   - `shared`: one `ConcurrentInternTable` for all threads, no lock on the lookup path.
+   The rate is million interns per second over all threads (best of `rounds`); `stored` is the number of texts the private tables hold together versus the shared table.
+3. `lex own` and `lex shared` time the same number of `Lexical` instances, each lexing the whole source with `lexText`, once with their own intern tables and once sharing one `ConcurrentInternTable` (`shareInternTable`).
+4. Each thread of the shared run sums the ids it got; all sums must be equal, and every lexeme must map back to its text. Otherwise the run fails.
+</summary>*/
+class InternContention
+{
+private:
+    string source;
+    vector<string_view> lexemes;
+
+    // Runs `work(thread)` on `threads` pool threads at once and returns the wall time in seconds
+    template <typename Work>
+    static double runThreads(unsigned threads, Work work)
+    {
+        ThreadPool pool(threads);
+        vector<future<void>> done;
+        done.reserve(threads);
+        auto start = chrono::steady_clock::now();
+        for (unsigned t = 0; t < threads; ++t)
+            done.push_back(pool.submit([&work, t]() { work(t); }));
+        for (future<void>& task : done)
+            task.get();
+        return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+
+    // The lexeme list in the order thread `t` of `threads` walks it
+    template <typename Visit>
+    void forEachLexeme(unsigned t, unsigned threads, Visit visit) const
+    {
+        const size_t count = lexemes.size();
+        const size_t first = count * t / threads;
+        for (size_t i = 0; i < count; ++i)
+            visit(lexemes[(first + i) % count]);
+    }
+
+public:
+    void load(double megabytes)
+    {
+        source = SourceGenerator::generate(*SourceGenerator::find("identifiers"), static_cast<size_t>(megabytes * 1024.0 * 1024.0));
+        lexemes.clear();
+        size_t i = 0;
+        while (i < source.size())
+        {
+            while (i < source.size() && isspace(static_cast<unsigned char>(source[i])))
+                ++i;
+            size_t start = i;
+            while (i < source.size() && !isspace(static_cast<unsigned char>(source[i])))
+                ++i;
+            if (i > start)
+                lexemes.emplace_back(source.data() + start, i - start);
+        }
+    }
+
+    int run(unsigned maxThreads, int rounds)
+    {
+        const double interns = static_cast<double>(lexemes.size());
+        cout << "Intern contention (" << lexemes.size() << " lexemes per thread, " << fixed << setprecision(2)
+            << source.size() / (1024.0 * 1024.0) << " MB source, best of " << rounds << " rounds, " << thread::hardware_concurrency() << " hardware threads)\n";
+        cout << right << setw(8) << "threads" << setw(12) << "private" << setw(12) << "locked" << setw(12) << "shared"
+            << setw(14) << "stored priv" << setw(14) << "stored shr" << setw(12) << "lex own" << setw(12) << "lex shared" << "\n";
+        cout << right << setw(8) << "" << setw(12) << "Mint/s" << setw(12) << "Mint/s" << setw(12) << "Mint/s"
+            << setw(14) << "texts" << setw(14) << "texts" << setw(12) << "ms" << setw(12) << "ms" << "\n";
+
+        int result = 0;
+        for (unsigned threads = 1; threads <= maxThreads; threads *= 2)
+        {
+            double bestPrivate = 1e30, bestLocked = 1e30, bestShared = 1e30, bestLexOwn = 1e30, bestLexShared = 1e30;
+            size_t storedPrivate = 0, storedShared = 0;
+            for (int r = 0; r < rounds; ++r)
+            {
+                vector<InternTable> privateTables(threads);
+                bestPrivate = min(bestPrivate, runThreads(threads, [&](unsigned t)
+                {
+                    forEachLexeme(t, threads, [&](string_view lexeme) { privateTables[t].intern(lexeme); });
+                }));
+                storedPrivate = 0;
+                for (const InternTable& table : privateTables)
+                    storedPrivate += table.size();
+
+                InternTable lockedTable;
+                mutex tableMutex;
+                bestLocked = min(bestLocked, runThreads(threads, [&](unsigned t)
+                {
+                    forEachLexeme(t, threads, [&](string_view lexeme)
+                    {
+                        lock_guard<mutex> lock(tableMutex);
+                        lockedTable.intern(lexeme);
+                    });
+                }));
+
+                ConcurrentInternTable sharedTable(lexemes.size());
+                vector<unsigned long long> idSums(threads, 0);
+                bestShared = min(bestShared, runThreads(threads, [&](unsigned t)
+                {
+                    unsigned long long sum = 0;
+                    forEachLexeme(t, threads, [&](string_view lexeme) { sum += sharedTable.intern(lexeme); });
+                    idSums[t] = sum;
+                }));
+                storedShared = sharedTable.size();
+                if (count(idSums.begin(), idSums.end(), idSums[0]) != static_cast<ptrdiff_t>(threads) || sharedTable.size() != lockedTable.size())
+                    result = 1;
+                for (string_view lexeme : lexemes)
+                    if (sharedTable.text(sharedTable.intern(lexeme)) != lexeme)
+                        result = 1;
+
+                vector<Lexical> lexers(threads);
+                bestLexOwn = min(bestLexOwn, runThreads(threads, [&](unsigned t) { lexers[t].lexText(source); }));
+                ConcurrentInternTable lexerTable(lexemes.size());
+                for (Lexical& lexer : lexers)
+                    lexer.shareInternTable(&lexerTable);
+                bestLexShared = min(bestLexShared, runThreads(threads, [&](unsigned t) { lexers[t].lexText(source); }));
+                for (Lexical& lexer : lexers)
+                    lexer.shareInternTable(nullptr);
+            }
+
+            cout << right << setw(8) << threads << fixed << setprecision(2)
+                << setw(12) << threads * interns / bestPrivate / 1e6
+                << setw(12) << threads * interns / bestLocked / 1e6
+                << setw(12) << threads * interns / bestShared / 1e6
+                << setw(14) << storedPrivate << setw(14) << storedShared
+                << setw(12) << bestLexOwn * 1000.0 << setw(12) << bestLexShared * 1000.0 << "\n";
+        }
+        if (result != 0)
+            cerr << "Error: threads disagree on the ids of the shared intern table\n";
+        return result;
+    }
+};
+
+// |-------------------------------------------------------------------------------------------------------------|
+// |                                              Small Inputs                                                   |
+// |-------------------------------------------------------------------------------------------------------------|
+
+/* <summary>
+The `SmallInputs` class measures the load of a server that lexes many small, independent inputs on many threads.
+
+Logic:
+1. `count` sources of about `bytes` bytes each are generated from the `mixed` profile, each with its own seed.
+2. For each thread count (1, 2, 4, ... up to the maximum) the inputs are split evenly over the threads of a `ThreadPool` and lexed with `lexText`, in two ways:
+   - `fresh`: a new `Lexical` for every input. All of them share the default `ScannerDefinition`, so this costs no table construction.
+   - `reused`: one `Lexical` per thread for all its inputs; every run resets the counters and the token stream.
+   The rate is inputs per second over all threads (best of `rounds`), with the matching MB/s.
+3. The token count of every input must be the same in every run; otherwise the benchmark fails.
+</summary>*/
+class SmallInputs
+{
+private:
+    vector<string> sources;
+    size_t totalBytes = 0;
+
+public:
+    void load(size_t count, size_t bytes)
+    {
+        sources.clear();
+        totalBytes = 0;
+        const SourceGenerator::Profile& profile = *SourceGenerator::find("mixed");
+        for (size_t i = 0; i < count; ++i)
+        {
+            sources.push_back(SourceGenerator::generate(profile, bytes, static_cast<uint32_t>(1000 + i)));
+            totalBytes += sources.back().size();
+        }
+    }
+
+    int run(unsigned maxThreads, int rounds)
+    {
+        const double megabytes = static_cast<double>(totalBytes) / (1024.0 * 1024.0);
+        cout << "Small inputs (" << sources.size() << " inputs, " << totalBytes / max<size_t>(sources.size(), 1) << " bytes each, best of " << rounds << " rounds)\n";
+        cout << right << setw(8) << "threads" << setw(14) << "fresh in/s" << setw(10) << "MB/s" << setw(14) << "reused in/s" << setw(10) << "MB/s" << "\n";
+
+        int result = 0;
+        vector<size_t> expected;
+        for (unsigned threads = 1; threads <= maxThreads; threads *= 2)
+        {
+            double best[2] = { 1e30, 1e30 };
+            for (int r = 0; r < rounds; ++r)
+            {
+                for (int reuse = 0; reuse < 2; ++reuse)
+                {
+                    vector<size_t> tokenCounts(sources.size(), 0);
+                    ThreadPool pool(threads);
+                    vector<future<void>> done;
+                    auto start = chrono::steady_clock::now();
+                    for (unsigned t = 0; t < threads; ++t)
+                    {
+                        done.push_back(pool.submit([this, &tokenCounts, threads, reuse, t]()
+                        {
+                            Lexical reused;
+                            for (size_t i = t; i < sources.size(); i += threads)
+                            {
+                                if (reuse)
+                                {
+                                    reused.lexText(sources[i]);
+                                    tokenCounts[i] = reused.getTokens().size();
+                                }
+                                else
+                                {
+                                    Lexical fresh;
+                                    fresh.lexText(sources[i]);
+                                    tokenCounts[i] = fresh.getTokens().size();
+                                }
+                            }
+                        }));
+                    }
+                    for (future<void>& task : done)
+                        task.get();
+                    best[reuse] = min(best[reuse], chrono::duration<double>(chrono::steady_clock::now() - start).count());
+
+                    if (expected.empty())
+                        expected = tokenCounts;
+                    else if (tokenCounts != expected)
+                        result = 1;
+                }
+            }
+
+            cout << right << setw(8) << threads << fixed << setprecision(0)
+                << setw(14) << sources.size() / best[0] << setw(10) << setprecision(1) << megabytes / best[0]
+                << setw(14) << setprecision(0) << sources.size() / best[1] << setw(10) << setprecision(1) << megabytes / best[1] << "\n";
+        }
+        if (result != 0)
+            cerr << "Error: token counts differ between runs of the same input\n";
+        return result;
+    }
+};
+
+// |-------------------------------------------------------------------------------------------------------------|
+// |                                              Lexer Benchmark                                                |
+// |-------------------------------------------------------------------------------------------------------------|
+
+/* <summary>
+The `LexicalBenchmark` class measures the inner loops of the `Lexical` scanner in isolation. It is a friend of `Lexical`, so it can call the private FSM drivers directly on a prepared list of tokens without any file output getting in the way.
+
+Logic:
+1. `loadTokens` splits an input file into raw tokens the same way `PerformLexical` does (whitespace and `$ , ; ( )` separate tokens, the separators themselves are kept as one-character tokens).
+2. `compareFSMDrivers` runs every token through the four machines with three drivers:
+   - `legacyFSM`: the original driver, which calls the column-mapping function through a pointer for each character and looks the final state up in an `unordered_map`.
+   - `runtimeTableFSM`: byte-to-column table plus flattened transition table, with the dimensions passed at run time.
+   - `Lexical::runFSM`: the driver the scanner uses, instantiated per machine with the table, column table and accepting states as compile-time constants. In a `LEXICAL_DIRECT_CODED` build the scanner's wrappers call the generated direct-coded machines instead, and the row is labelled `direct`.
+3. `compareKeywordLookup` checks every token against the keyword list, once with a `std::unordered_set<std::string>` (the previous `isKeyword`) and once with the compile-time perfect hash behind `Lexical::isKeyword`.
+4. `compareDelimiterScan` finds the token boundaries of the whole input, once with the per-character `isDelimiter` loop `scanBuffer` used before and once with each `DelimiterScan` kernel the CPU supports (scalar, SSE2, AVX2). The checksum adds up the token start and end positions.
+5. Each variant is run `rounds` times and the fastest round is reported, together with the throughput in MB/s and a checksum of the accepted states, which must be equal for all drivers.
+</summary>*/
+class LexicalBenchmark
+{
+private:
+    Lexical lexical;
+    string text;
+    vector<string> tokens;
+    size_t totalBytes = 0;
+
+    const unordered_map<int, bool> identifierStates = { {3, true} };
+    const unordered_map<int, bool> numberStates = { {2, true}, {4, true}, {7, true} };
+    const unordered_map<int, bool> punctuationStates = { {1, true} };
+    const unordered_map<int, bool> operatorStates = { {13, true}, {6, true}, {7, true}, {8, true}, {9, true}, {12, true}, {5, true} };
+
+    // The machines are compile-time constants, so their behavior is checked at compile time as well
+    static_assert(Lexical::runFSM<Lexical::identifierTable, Lexical::identifierColumns, Lexical::identifierAccept>("_a1") == 3, "identifier FSM");
+    static_assert(Lexical::runFSM<Lexical::numberTable, Lexical::numberColumns, Lexical::numberAccept>("-1.5e+3") == 7, "number FSM");
+    static_assert(Lexical::runFSM<Lexical::punctuationTable, Lexical::punctuationColumns, Lexical::punctuationAccept>("{") == 1, "punctuation FSM");
+    static_assert(Lexical::runFSM<Lexical::operatorTable, Lexical::operatorColumns, Lexical::operatorAccept>("!") == -1, "operator FSM");
+
+    // The keyword set `isKeyword` used before the perfect hash
+    unordered_set<string> keywordSet;
+
+    // The driver `Lexical` used before the byte-to-column tables: one indirect call per character
+    template <size_t NumColumns>
+    static int legacyFSM(const string& token, const int table[][NumColumns], int numColumns, int (*getCol)(char), const unordered_map<int, bool>& validStates)
+    {
+        int state = 0;
+        for (char c : token)
+        {
+            int col = getCol(c);
+            if (col >= numColumns || col < 0)
+                return -1;
+            state = table[state][col];
+            if (state == -1)
+                return -1;
+        }
+        return validStates.count(state) ? state : -1;
+    }
+
+    // Byte-to-column table and flattened transition table, dimensions known only at run time
+    static int runtimeTableFSM(const string& token, const int* transitions, int numColumns, const unsigned char* columns, const unordered_map<int, bool>& validStates)
+    {
+        int state = 0;
+        for (char c : token)
+        {
+            state = transitions[state * numColumns + columns[static_cast<unsigned char>(c)]];
+            if (state < 0)
+                return -1;
+        }
+        return validStates.count(state) ? state : -1;
+    }
+
+    // The four machines as the cascade uses them: original driver
+    long long runLegacy()
+    {
+        long long checksum = 0;
+        for (const string& token : tokens)
+        {
+            checksum += legacyFSM(token, Lexical::identifierTable, 4, &Lexical::getIdentifierCol, identifierStates);
+            checksum += legacyFSM(token, Lexical::numberTable, 6, &Lexical::getNumberCol, numberStates);
+            checksum += legacyFSM(token, Lexical::operatorTable, 13, &Lexical::getOperatorCol, operatorStates);
+            if (token.size() == 1)
+                checksum += legacyFSM(token, Lexical::punctuationTable, 7, &Lexical::getPunctuationCol, punctuationStates);
+        }
+        return checksum;
+    }
+
+    // The four machines as the cascade uses them: run-time table driver
+    long long runTables()
+    {
+        long long checksum = 0;
+        for (const string& token : tokens)
+        {
+            checksum += runtimeTableFSM(token, &Lexical::identifierTable[0][0], 4, Lexical::identifierColumns.data(), identifierStates);
+            checksum += runtimeTableFSM(token, &Lexical::numberTable[0][0], 5, Lexical::numberColumns.data(), numberStates);
+            checksum += runtimeTableFSM(token, &Lexical::operatorTable[0][0], 13, Lexical::operatorColumns.data(), operatorStates);
+            if (token.size() == 1)
+                checksum += runtimeTableFSM(token, &Lexical::punctuationTable[0][0], 7, Lexical::punctuationColumns.data(), punctuationStates);
+        }
+        return checksum;
+    }
+
+    // The four machines as the cascade uses them: per-machine compile-time driver
+    long long runSpecialized()
+    {
+        long long checksum = 0;
+        for (const string& token : tokens)
+        {
+            checksum += lexical.identifierFSM(token);
+            checksum += lexical.numberFSM(token);
+            checksum += lexical.operatorFSM(token);
+            if (token.size() == 1)
+                checksum += lexical.punctuationFSM(token);
+        }
+        return checksum;
+    }
+
+    long long runKeywordSet()
+    {
+        long long hits = 0;
+        for (const string& token : tokens)
+            hits += keywordSet.find(token) != keywordSet.end();
+        return hits;
+    }
+
+    long long runKeywordHash()
+    {
+        long long hits = 0;
+        for (const string& token : tokens)
+            hits += Lexical::isKeyword(token);
+        return hits;
+    }
+
+    // Token boundaries, one character at a time
+    long long runDelimiterLoop()
+    {
+        long long checksum = 0;
+        bool inToken = false;
+        for (size_t i = 0; i < text.size(); ++i)
+        {
+            bool delimiter = lexical.isDelimiter(text[i]);
+            if (delimiter == inToken)
+            {
+                checksum += i;
+                inToken = !inToken;
+            }
+        }
+        return inToken ? checksum + text.size() : checksum;
+    }
+
+    // Token boundaries with the active `DelimiterScan` kernel
+    long long runDelimiterScan()
+    {
+        long long checksum = 0;
+        const char* data = text.data();
+        size_t i = 0;
+        while (i < text.size())
+        {
+            size_t tokenStart = DelimiterScan::skipDelimiters(data, i, text.size());
+            if (tokenStart == text.size())
+                break;
+            i = DelimiterScan::findDelimiter(data, tokenStart, text.size());
+            checksum += tokenStart + i;
+        }
+        return checksum;
+    }
+
+    template <typename Body>
+    double bestSeconds(int rounds, Body body, long long& checksum)
+    {
+        double best = 0.0;
+        for (int r = 0; r < rounds; ++r)
+        {
+            auto start = chrono::steady_clock::now();
+            checksum = body();
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            if (r == 0 || seconds < best)
+                best = seconds;
+        }
+        return best;
+    }
+
+    void report(const string& name, double seconds, long long checksum, size_t bytes = 0)
+    {
+        double megabytes = static_cast<double>(bytes ? bytes : totalBytes) / (1024.0 * 1024.0);
+        cout << left << setw(12) << name
+            << right << setw(12) << fixed << setprecision(3) << seconds * 1000.0 << " ms"
+            << setw(12) << setprecision(1) << (seconds > 0 ? megabytes / seconds : 0.0) << " MB/s"
+            << "   checksum " << checksum << "\n";
+    }
+
+public:
+    bool loadTokens(const string& fileName)
+    {
+        ifstream input(fileName, ios::binary);
+        if (!input.is_open())
+            return false;
+
+        stringstream content;
+        content << input.rdbuf();
+        text = content.str();
+
+        size_t start = 0;
+        for (size_t i = 0; i <= text.size(); ++i)
+        {
+            if (i < text.size() && !lexical.isDelimiter(text[i]))
+                continue;
+            if (i > start)
+                tokens.push_back(text.substr(start, i - start));
+            if (i < text.size() && !isspace(text[i]))
+                tokens.push_back(string(1, text[i]));
+            start = i + 1;
+        }
+
+        for (const string& token : tokens)
+            totalBytes += token.size();
+        for (string_view keyword : Lexical::keywords)
+            keywordSet.insert(string(keyword));
+        return true;
+    }
+
+    size_t tokenCount() const { return tokens.size(); }
+    size_t byteCount() const { return totalBytes; }
+
+    int compareFSMDrivers(int rounds)
+    {
+        long long legacyChecksum = 0, tableChecksum = 0, specializedChecksum = 0;
+        double legacySeconds = bestSeconds(rounds, [this]() { return runLegacy(); }, legacyChecksum);
+        double tableSeconds = bestSeconds(rounds, [this]() { return runTables(); }, tableChecksum);
+        double specializedSeconds = bestSeconds(rounds, [this]() { return runSpecialized(); }, specializedChecksum);
+
+        cout << "FSM drivers (best of " << rounds << " rounds)\n";
+        report("legacy", legacySeconds, legacyChecksum);
+        report("table", tableSeconds, tableChecksum);
+#ifdef LEXICAL_DIRECT_CODED
+        report("direct", specializedSeconds, specializedChecksum);
+#else
+        report("runFSM<>", specializedSeconds, specializedChecksum);
+#endif
+        if (specializedSeconds > 0)
+            cout << "speedup     " << setprecision(2) << legacySeconds / specializedSeconds << "x\n";
+
+        if (legacyChecksum != tableChecksum || legacyChecksum != specializedChecksum)
+        {
+            cerr << "Error: FSM drivers disagree\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    int compareKeywordLookup(int rounds)
+    {
+        long long setHits = 0, hashHits = 0;
+        double setSeconds = bestSeconds(rounds, [this]() { return runKeywordSet(); }, setHits);
+        double hashSeconds = bestSeconds(rounds, [this]() { return runKeywordHash(); }, hashHits);
+
+        cout << "Keyword lookup (best of " << rounds << " rounds)\n";
+        report("hash set", setSeconds, setHits);
+        report("perfect", hashSeconds, hashHits);
+        if (hashSeconds > 0)
+            cout << "speedup     " << setprecision(2) << setSeconds / hashSeconds << "x\n";
+        if (!tokens.empty())
+            cout << "per lookup  " << setprecision(2) << setSeconds * 1e9 / tokens.size() << " ns vs " << hashSeconds * 1e9 / tokens.size() << " ns\n";
+
+        if (setHits != hashHits)
+        {
+            cerr << "Error: keyword lookups disagree\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    int compareDelimiterScan(int rounds)
+    {
+        long long loopChecksum = 0;
+        double loopSeconds = bestSeconds(rounds, [this]() { return runDelimiterLoop(); }, loopChecksum);
+
+        cout << "Delimiter scan (best of " << rounds << " rounds, " << text.size() << " bytes)\n";
+        report("isDelimiter", loopSeconds, loopChecksum, text.size());
+
+        const DelimiterScan::Kernel detected = DelimiterScan::detect();
+        const DelimiterScan::Kernel kernels[] = { DelimiterScan::Kernel::Scalar, DelimiterScan::Kernel::SSE2, DelimiterScan::Kernel::AVX2 };
+        const char* names[] = { "scalar", "sse2", "avx2" };
+        int result = 0;
+        for (int k = 0; k < 3 && static_cast<int>(kernels[k]) <= static_cast<int>(detected); ++k)
+        {
+            DelimiterScan::use(kernels[k]);
+            long long checksum = 0;
+            double seconds = bestSeconds(rounds, [this]() { return runDelimiterScan(); }, checksum);
+            report(names[k], seconds, checksum, text.size());
+            if (seconds > 0)
+                cout << "speedup     " << setprecision(2) << loopSeconds / seconds << "x\n";
+            if (checksum != loopChecksum)
+                result = 1;
+        }
+        DelimiterScan::use(detected);
+
+        if (result != 0)
+            cerr << "Error: delimiter scans disagree\n";
+        return result;
+    }
+};
+
+/* <summary>
+This is the entry point of the benchmark program.
+
+Logic:
+1. `--suite [megabytes] [rounds] [profile]` runs the `ThroughputSuite` on generated sources of the given size (default 8 MB) and rounds (default 5), for one profile or all of them.
+2. `--generate <profile> <megabytes> <file>` writes a generated source to a file, e.g. to lex or profile it separately.
+3. `--intern [max threads] [megabytes] [rounds]` runs the `InternContention` benchmark from 1 up to the given number of threads (default 64) on a generated source (default 1 MB), best of the given rounds (default 3).
+4. `--small [max threads] [inputs] [bytes] [rounds]` runs the `SmallInputs` benchmark from 1 up to the given number of threads (default 8) on the given number of generated inputs (default 2000) of the given size (default 2048 bytes), best of the given rounds (default 3).
+5. Otherwise the input file is taken from the first argument (default `test_code.txt`), the number of rounds from the second one (default 20).
+   Load and split the input, then compare the FSM drivers, the keyword lookups and the delimiter scans on it.
+6. Return non-zero if the input cannot be read or two variants disagree.
+</summary> */
+int main(int argc, char* argv[])
+{
+    if (argc > 1 && string(argv[1]) == "--suite")
+    {
+        double megabytes = argc > 2 ? atof(argv[2]) : 8.0;
+        int suiteRounds = argc > 3 ? atoi(argv[3]) : 5;
+        if (suiteRounds < 1)
+            suiteRounds = 1;
+        const SourceGenerator::Profile* only = argc > 4 ? SourceGenerator::find(argv[4]) : nullptr;
+        if (argc > 4 && !only)
+        {
+            cerr << "Error: Unknown profile " << argv[4] << "\n";
+            return 1;
+        }
+
+        cout << "Scanner build: " << scannerBuild << "\n\n";
+        ThroughputSuite suite;
+        int result = 0;
+        for (const SourceGenerator::Profile& profile : SourceGenerator::profiles())
+        {
+            if (only && only != &profile)
+                continue;
+            result |= suite.run(profile, static_cast<size_t>(megabytes * 1024.0 * 1024.0), suiteRounds);
+            cout << "\n";
+        }
+        return result;
+    }
+
+    if (argc > 4 && string(argv[1]) == "--generate")
+    {
+        const SourceGenerator::Profile* profile = SourceGenerator::find(argv[2]);
+        if (!profile)
+        {
+            cerr << "Error: Unknown profile " << argv[2] << "\n";
+            return 1;
+        }
+        string text = SourceGenerator::generate(*profile, static_cast<size_t>(atof(argv[3]) * 1024.0 * 1024.0));
+        ofstream output(argv[4], ios::binary);
+        output.write(text.data(), static_cast<streamsize>(text.size()));
+        return output ? 0 : 1;
+    }
+
+    if (argc > 1 && string(argv[1]) == "--intern")
+    {
+        int maxThreads = argc > 2 ? atoi(argv[2]) : 64;
+        double megabytes = argc > 3 ? atof(argv[3]) : 1.0;
+        int internRounds = argc > 4 ? atoi(argv[4]) : 3;
+        InternContention contention;
+        contention.load(megabytes);
+        return contention.run(static_cast<unsigned>(max(maxThreads, 1)), max(internRounds, 1));
+    }
+
+    if (argc > 1 && string(argv[1]) == "--small")
+    {
+        int maxThreads = argc > 2 ? atoi(argv[2]) : 8;
+        int inputs = argc > 3 ? atoi(argv[3]) : 2000;
+        int bytes = argc > 4 ? atoi(argv[4]) : 2048;
+        int smallRounds = argc > 5 ? atoi(argv[5]) : 3;
+        SmallInputs small;
+        small.load(static_cast<size_t>(max(inputs, 1)), static_cast<size_t>(max(bytes, 1)));
+        return small.run(static_cast<unsigned>(max(maxThreads, 1)), max(smallRounds, 1));
+    }
+
+    string fileName = argc > 1 ? argv[1] : "test_code.txt";
+    int rounds = argc > 2 ? atoi(argv[2]) : 20;
+    if (rounds < 1)
+        rounds = 1;
+
+    LexicalBenchmark benchmark;
+    if (!benchmark.loadTokens(fileName))
+    {
+        cerr << "Error: Could not open " << fileName << "\n";
+        return 1;
+    }
+
+    cout << "Input: " << fileName << " (" << benchmark.tokenCount() << " tokens, " << benchmark.byteCount() << " bytes)\n";
+    cout << "Scanner build: " << scannerBuild << "\n\n";
+    int result = benchmark.compareFSMDrivers(rounds);
+    cout << "\n";
+    result |= benchmark.compareKeywordLookup(rounds);
+    cout << "\n";
+    result |= benchmark.compareDelimiterScan(rounds);
+    return result;
+}
@@ -0,0 +1,198 @@
+﻿#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <array>
+#include "lexical.h"
+
+using namespace std;
+
+// |-------------------------------------------------------------------------------------------------------------|
+// |                                         Direct-Coded Scanner Generator                                      |
+// |-------------------------------------------------------------------------------------------------------------|
+
+/* <summary>
+The `ScannerGenerator` class writes `directScanner.h`, a direct-coded version of the DFAs `Lexical` scans with. It is a friend of `Lexical`, so it reads the very tables the table-driven scanner uses: the transition tables, column tables and accepting states of the four machines, and the merged DFA of the default `ScannerDefinition`.
+
+Logic:
+1. Every reachable DFA state becomes a label. At a label the generated code checks for the end of the token, loads the character class of the next byte and switches on it; each case is a `goto` to the label of the next state, and the default case leaves the function. The state lives in the program counter, so there is no transition table load and no state variable.
+2. Classes that lead to the same state share one case group. Transitions to a negative state (rejection) fall into the default case.
+3. The column tables are emitted as constant arrays, so the generated header only depends on `tokenStream.h` (for `TokenKind`).
+4. The four machines are emitted as functions with the contract of `Lexical::runFSM`: the accepting state the whole token ends in, or `-1`.
+5. The merged DFA is emitted as one function with the inner loop of `Lexical::scanMerged`: it reads as far as the DFA goes and records the end and kind of the longest accepted prefix and the end of the longest keyword candidate on entry to the corresponding states.
+6. Building `Lexical` with `LEXICAL_DIRECT_CODED` defined makes the FSM wrappers and `scanMerged` call the generated functions. The header has to be regenerated whenever a table in `lexical.h` changes.
+</summary>*/
+class ScannerGenerator
+{
+private:
+    const ScannerDefinition& definition = *Lexical::defaultDefinition();
+    ostringstream out;
+
+    void emitClassTable(const string& name, const unsigned char* classes)
+    {
+        out << "constexpr unsigned char " << name << "[256] =\n{";
+        for (int b = 0; b < 256; ++b)
+            out << (b % 32 == 0 ? "\n    " : " ") << static_cast<int>(classes[b]) << ",";
+        out << "\n};\n\n";
+    }
+
+    // The states some transition leads to; only they get a label, and states nothing leads to (except the start state) are left out
+    static vector<bool> targetedStates(const int* transitions, size_t rows, size_t columns)
+    {
+        vector<bool> targeted(rows, false);
+        for (size_t i = 0; i < rows * columns; ++i)
+            if (transitions[i] >= 0)
+                targeted[transitions[i]] = true;
+        return targeted;
+    }
+
+    // The `switch` of one state: `next(cls)` is the next state of a class, `jump(state)` the code that goes there
+    template <typename Next, typename Jump>
+    void emitSwitch(const string& classTable, int classCount, Next next, Jump jump, const string& reject)
+    {
+        out << "    switch (" << classTable << "[static_cast<unsigned char>(*p)])\n    {\n";
+        vector<bool> done(classCount, false);
+        for (int cls = 0; cls < classCount; ++cls)
+        {
+            int target = next(cls);
+            if (done[cls] || target < 0)
+                continue;
+            for (int other = cls; other < classCount; ++other)
+            {
+                if (!done[other] && next(other) == target)
+                {
+                    out << "    case " << other << ":\n";
+                    done[other] = true;
+                }
+            }
+            out << "        ++p;\n        " << jump(target) << "\n";
+        }
+        out << "    default:\n        " << reject << "\n    }\n";
+    }
+
+    // One of the four machines, as a function with the contract of `Lexical::runFSM`
+    template <size_t Rows, size_t Columns>
+    void emitMachine(const string& name, const int (&table)[Rows][Columns], unsigned accept, const array<unsigned char, 256>& columns)
+    {
+        const string classTable = name + "Class";
+        emitClassTable(classTable, columns.data());
+
+        out << "// " << name << "Table: " << Rows << " states, " << Columns << " columns\n";
+        out << "inline int " << name << "FSM(std::string_view token)\n{\n";
+        out << "    const char* p = token.data();\n    const char* const end = p + token.size();\n\n";
+        vector<bool> targeted = targetedStates(&table[0][0], Rows, Columns);
+        for (size_t state = 0; state < Rows; ++state)
+        {
+            if (!targeted[state] && state != 0)
+                continue;
+            const int result = ((accept >> state) & 1u) ? static_cast<int>(state) : -1;
+            if (targeted[state])
+                out << "S" << state << ":\n";
+            out << "    if (p == end)\n        return " << result << ";\n";
+            emitSwitch(classTable, static_cast<int>(Columns),
+                [&table, state](int cls) { return table[state][cls]; },
+                [](int target) { return "goto S" + to_string(target) + ";"; },
+                "return -1;");
+        }
+        out << "}\n\n";
+    }
+
+    // The merged DFA, as the inner loop of `Lexical::scanMerged`
+    void emitMerged()
+    {
+        const int classCount = definition.mergedClassCount;
+        const int stateCount = static_cast<int>(definition.mergedAccept.size());
+        emitClassTable("mergedClass", definition.mergedClass);
+
+        vector<bool> targeted = targetedStates(definition.mergedTransitions.data(), stateCount, classCount);
+
+        out << "// Merged DFA: " << stateCount << " states, " << classCount << " classes. Reads from `p` as far as the DFA goes and returns where it stopped;\n";
+        out << "// `acceptEnd`/`acceptKind` and `keywordEnd` are updated like in `Lexical::scanMerged`.\n";
+        out << "inline const char* merged(const char* p, const char* const end, const char*& acceptEnd, TokenKind& acceptKind, const char*& keywordEnd)\n{\n";
+        // The start state is entered without the bookkeeping on its label
+        if (targeted[0])
+            out << "    goto M0_next;\n\n";
+        for (int state = 0; state < stateCount; ++state)
+        {
+            if (!targeted[state] && state != 0)
+                continue;
+            if (targeted[state])
+                out << "M" << state << ":\n";
+            if (definition.mergedAccept[state] != TokenKind::Invalid)
+                out << "    acceptEnd = p;\n    acceptKind = TokenKind::" << kindName(definition.mergedAccept[state]) << ";\n";
+            if (definition.mergedKeywordCandidate[state])
+                out << "    keywordEnd = p;\n";
+            if (state == 0 && targeted[0])
+                out << "M0_next:\n";
+            out << "    if (p == end)\n        return p;\n";
+            emitSwitch("mergedClass", classCount,
+                [this, state, classCount](int cls) { return definition.mergedTransitions[state * classCount + cls]; },
+                [](int target) { return "goto M" + to_string(target) + ";"; },
+                "return p;");
+        }
+        out << "}\n\n";
+    }
+
+    static const char* kindName(TokenKind kind)
+    {
+        switch (kind)
+        {
+        case TokenKind::Keyword:
+            return "Keyword";
+        case TokenKind::Identifier:
+            return "Identifier";
+        case TokenKind::Number:
+            return "Number";
+        case TokenKind::Punctuation:
+            return "Punctuation";
+        case TokenKind::Operator:
+            return "Operator";
+        default:
+            return "Invalid";
+        }
+    }
+
+public:
+    string generate()
+    {
+        out.str("");
+        out << "// Generated by Scanner Generator.cpp from the tables in lexical.h. Do not edit; regenerate after changing a table.\n";
+        out << "#ifndef DIRECT_SCANNER_H\n#define DIRECT_SCANNER_H\n\n";
+        out << "#include <string_view>\n#include \"tokenStream.h\"\n\n";
+        out << "namespace DirectScanner\n{\n\n";
+        emitMachine("identifier", Lexical::identifierTable, Lexical::identifierAccept, Lexical::identifierColumns);
+        emitMachine("number", Lexical::numberTable, Lexical::numberAccept, Lexical::numberColumns);
+        emitMachine("punctuation", Lexical::punctuationTable, Lexical::punctuationAccept, Lexical::punctuationColumns);
+        emitMachine("operator", Lexical::operatorTable, Lexical::operatorAccept, Lexical::operatorColumns);
+        emitMerged();
+        out << "} // namespace DirectScanner\n\n#endif // DIRECT_SCANNER_H\n";
+        return out.str();
+    }
+};
+
+/* <summary>
+This is the entry point of the generator program.
+
+Logic:
+1. The output file is taken from the first argument (default `directScanner.h`).
+2. Generate the direct-coded scanner and write it to the file.
+3. Build the scanner or the benchmark with `LEXICAL_DIRECT_CODED` defined to use it, and without to use the tables.
+</summary> */
+int main(int argc, char* argv[])
+{
+    string fileName = argc > 1 ? argv[1] : "directScanner.h";
+
+    ScannerGenerator generator;
+    string code = generator.generate();
+
+    ofstream output(fileName);
+    if (!output.is_open())
+    {
+        cerr << "Error: Could not open " << fileName << "\n";
+        return 1;
+    }
+    output << code;
+    cout << "Direct-coded scanner written to " << fileName << "\n";
+    return output ? 0 : 1;
+}
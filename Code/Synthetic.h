@@ -7,10 +7,18 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <sstream>
-#include <stack>
 #include <vector>
 #include <iomanip>
 #include <algorithm>
+#include <cstdint>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#include "tokenStream.h"
+#include "binaryTokenFile.h"
+#include "reportWriter.h"
+#include "diagnostics.h"
+#include "threadPool.h"
 
 /*
 CFG Rules for my Language:
@@ -47,6 +55,75 @@ CFG Rules for my Language:
 */
 
 
+/* <summary>
+The `SymbolSets` class stores one set of terminals per row, as a row of bits: bit `c` of a row is the terminal in column `c` (its symbol id minus the number of non-terminals). `Synthetic` keeps its FIRST and FOLLOW sets and the FIRST sets of the production suffixes in it, so the union of two sets is a loop over a few 64-bit words.
+</summary>*/
+class SymbolSets
+{
+private:
+    size_t columns = 0;
+    size_t words = 0;
+    std::vector<uint64_t> bits;
+
+    // The index of the lowest set bit of a non-zero word
+    static size_t lowestBit(uint64_t word)
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanForward64(&index, word);
+        return static_cast<size_t>(index);
+#else
+        return static_cast<size_t>(__builtin_ctzll(word));
+#endif
+    }
+
+public:
+    // Makes `rowCount` empty rows of `columnCount` bits
+    void assign(size_t rowCount, size_t columnCount)
+    {
+        columns = columnCount;
+        words = (columnCount + 63) / 64;
+        bits.assign(rowCount * words, 0);
+    }
+
+    size_t columnCount() const { return columns; }
+    void insert(size_t row, size_t column) { bits[row * words + column / 64] |= uint64_t(1) << (column % 64); }
+
+    // A column outside the rows (e.g. of a symbol that is not a terminal) is in no set
+    bool contains(size_t row, size_t column) const
+    {
+        return column < columns && (bits[row * words + column / 64] >> (column % 64) & 1) != 0;
+    }
+
+    // Adds row `from` of `source` (which may be this object) to row `into`; returns whether `into` changed
+    bool unite(size_t into, const SymbolSets& source, size_t from)
+    {
+        uint64_t* target = bits.data() + into * words;
+        const uint64_t* added = source.bits.data() + from * words;
+        uint64_t changed = 0;
+        for (size_t w = 0; w < words; ++w)
+        {
+            changed |= added[w] & ~target[w];
+            target[w] |= added[w];
+        }
+        return changed != 0;
+    }
+
+    // Calls `visit(column)` for the members of a row, in increasing order
+    template <typename Visit>
+    void forEach(size_t row, Visit visit) const
+    {
+        const uint64_t* at = bits.data() + row * words;
+        for (size_t w = 0; w < words; ++w)
+        {
+            for (uint64_t word = at[w]; word != 0; word &= word - 1)
+            {
+                visit(w * 64 + lowestBit(word));
+            }
+        }
+    }
+};
+
 /* <summary>
 The `Synthetic` class is responsible for performing syntactic analysis on a context-free grammar (CFG). This class facilitates the parsing process, including generating and analyzing FIRST and FOLLOW sets, eliminating left recursion and left factoring, and building a parse table. The class can also parse input strings and files based on the constructed parse table, while also outputting relevant results (such as the grammar, FIRST/ FOLLOW sets, and parse table) to various files.
 The functinos in it are related to:
@@ -60,10 +137,13 @@ The functinos in it are related to:
 ### Private Member Variables:
 - `firstSetFile`, `followSetFile`, `parseTableFile`, `parsingFile`, `parsingTree`, `errorFile`, `grammarFile`: Output files for storing FIRST sets, FOLLOW sets, parse table, parsing steps, error logs, and grammar.
 - `EPSILON`: A constant string representing the epsilon symbol in grammar.
-- `grammar`: A map representing the grammar where the key is a non-terminal, and the value is a set of its productions.
-- `firstSets`: A map representing the FIRST sets for each non-terminal.
-- `followSets`: A map representing the FOLLOW sets for each non-terminal.
-- `parseTable`: A map representing the parse table, with non-terminals as keys and another map containing terminal symbols and corresponding production rules.
+- `grammar`: A map representing the grammar where the key is a non-terminal, and the value is a set of its productions. Loading and the left recursion / left factoring transformations work on it.
+- `symbolNames`, `symbolIds`: The symbol table of the compiled grammar (`compileGrammar`). Every non-terminal and terminal has a dense integer id; non-terminals come first.
+- `ruleStart`, `productionStart`, `productionSymbols`, `productionLhs`, `productionText`: The productions, pre-tokenized into symbol ids and stored back to back in one array.
+- `nullable`, `firstSets`, `followSets`: Whether each non-terminal derives ε, and its FIRST and FOLLOW sets, as bit rows over the terminals (`SymbolSets`).
+- `suffixFirst`, `suffixNullable`: The FIRST set of every production suffix and whether it derives ε, used by the parse table.
+- `threadCount`, `minParallelNonTerminals`: The worker threads of the FIRST/FOLLOW and parse table construction, and the grammar size from which they are used.
+- `parseTable`: The parse table, a dense non-terminal × terminal array of 16-bit production indices, with `errorEntry` for empty cells and `syncEntry` for the panic mode synchronization cells.
 
 It includes both private and public methods for processing the grammar and performing the syntactic analysis. The class is designed to work with context-free grammars that may need transformations to be suitable for LL(1) parsing.
 ### Public Functions:
@@ -74,7 +154,7 @@ It includes both private and public methods for processing the grammar and perfo
 5. **buildParseTable**: Constructs the LL(1) parse table for the grammar.
 6. **writeParseTableToFile**: Writes the constructed parse table to a file.
 7. **printParseTable**: Prints the parse table to the console.
-8. **printTree**: Recursively prints the parsing tree for a given symbol.
+8. **printTree**: Prints the parse tree recorded by `parseInput`.
 9. **parseInput**: Parses an input string based on the constructed parse table.
 10. **parseFromFile**: Parses an input string from a file using the parse table.
 
@@ -87,13 +167,15 @@ It includes both private and public methods for processing the grammar and perfo
 6. **trim**: Trims leading and trailing spaces from a string.
 7. **removeLeftRecursion**: Removes left recursion from the grammar.
 8. **removeLeftFactoring**: Removes left factoring from the grammar.
-9. **computeFollow**: Computes the FOLLOW set for a non-terminal.
-10. **computeFirst**: Computes the FIRST set for a non-terminal.
-11. **isTerminal**: Checks if a token is a terminal.
+9. **computeFollow**: Computes the FOLLOW sets of all non-terminals.
+10. **computeFirst**: Computes the nullable non-terminals, their FIRST sets and the FIRST sets of the production suffixes.
+11. **isTerminal**: Checks if a symbol id is a terminal.
 12. **computeAllTerminals**: Computes the set of all terminal symbols.
 13. **printFollowSetsToFile**: Prints the FOLLOW sets to a file.
 14. **printFirstSetsToFile**: Prints the FIRST sets to a file.
 15. **printGrammar**: Prints the grammar to the console.
+16. **compileGrammar**: Assigns the symbol ids and stores the productions as arrays of ids.
+17. **propagate**: Solves FIRST or FOLLOW sets along their dependencies, one strongly connected component at a time and independent components in parallel.
 </summary>
 */
 class Synthetic 
@@ -116,11 +198,77 @@ private:
     std::ofstream errorFile;
     std::ofstream grammarFile;
 
+    // Parsing artifacts that are written, and the console log: how much of it, and where to
+    ArtifactSet artifacts;
+    Verbosity verbosity = Verbosity::Verbose;
+    DiagnosticSink* sink = &consoleSink();
+    ReportWriter console;
+
+    // Inputs parsed, and inputs that failed, since the parsing files were opened
+    int parsedInputs = 0;
+    int failedInputs = 0;
+
     const std::string EPSILON = "ε";
     std::unordered_map<std::string, std::unordered_set<std::string>> grammar;
-    std::unordered_map<std::string, std::unordered_set<std::string>> firstSets;
-    std::unordered_map<std::string, std::unordered_set<std::string>> followSets;
-    std::unordered_map<std::string, std::unordered_map<std::string, std::string>> parseTable;
+
+    // Symbol table of the compiled grammar: non-terminals are 0 .. nonTerminalCount - 1 in the order of `grammar`, terminals follow
+    std::vector<std::string> symbolNames;
+    std::unordered_map<std::string, int> symbolIds;
+    int nonTerminalCount = 0;
+    int endSymbol = -1;      // "$"
+    int startSymbol = 0;     // the non-terminal FOLLOW starts from
+    std::string grammarStart; // the first non-terminal of the grammar file
+
+    // Productions: production p is productionSymbols[productionStart[p] .. productionStart[p + 1]), and non-terminal n has productions ruleStart[n] .. ruleStart[n + 1] - 1
+    std::vector<int> ruleStart;
+    std::vector<int> productionStart;
+    std::vector<int> productionSymbols;
+    std::vector<int> productionLhs;
+    std::vector<std::string> productionText;
+
+    // What an expansion pushes onto the parse stack: production p as pushSymbols[pushStart[p] .. pushStart[p + 1]), its symbols in reverse order (none for an epsilon production)
+    std::vector<int> pushStart;
+    std::vector<int> pushSymbols;
+
+    // The parse stack of `parseInput`, top at the back; kept between inputs so it does not allocate again
+    std::vector<int> parseStack;
+
+    // A node of the parse tree: its symbol, its parent node (-1 for the root) and, once expanded, its children nodes[firstChild .. firstChild + childCount)
+    struct ParseNode
+    {
+        int symbol;
+        int parent;
+        int firstChild;
+        int childCount;
+    };
+
+    // The parse tree of `parseInput` as a node list, and the node of every parse stack entry (-1 for the end marker); kept between inputs like `parseStack`
+    std::vector<ParseNode> parseNodes;
+    std::vector<int> nodeStack;
+
+    // FIRST and FOLLOW sets of the non-terminals, rows indexed by non-terminal id
+    std::vector<char> nullable;
+    SymbolSets firstSets;
+    SymbolSets followSets;
+
+    // FIRST of the suffix of production p that starts at position `at` (productionStart[p] <= at <= productionStart[p + 1]) is row at + p
+    SymbolSets suffixFirst;
+    std::vector<char> suffixNullable;
+
+    // Non-terminal n occurs at the positions occurrences[occurrenceStart[n] .. occurrenceStart[n + 1]) of productionSymbols; position `at` is in production positionProduction[at]
+    std::vector<int> occurrenceStart;
+    std::vector<int> occurrences;
+    std::vector<int> positionProduction;
+
+    // Worker threads of `computeFirstAndFollow` and `buildParseTable`, and the grammar size from which they are used
+    unsigned threadCount = std::thread::hardware_concurrency();
+    int minParallelNonTerminals = 1024;
+
+    // Parse table: the entry of (non-terminal n, terminal t) is parseTable[n * tableColumns + t - nonTerminalCount], a production index or one of these codes
+    static constexpr uint16_t errorEntry = UINT16_MAX;
+    static constexpr uint16_t syncEntry = UINT16_MAX - 1;
+    std::vector<uint16_t> parseTable;
+    int tableColumns = 0;
     // |-------------------------------------------------------------------------------------------------------------|
     // |                                          Helper Functions                                                   |
     // |-------------------------------------------------------------------------------------------------------------|
@@ -318,68 +466,222 @@ private:
     }
 
     /* <summary>
-    This function checks whether a given token is a terminal symbol in the grammar.
+    This function checks whether a given symbol id is a terminal symbol in the compiled grammar.
 
     The function works as follows:
 
-    1. **Look for the Token in Grammar**:
-       - It checks if the provided token exists as a key in the `grammar` map (which contains non-terminal symbols as keys).
+    1. **Compare with the Non-Terminal Range**:
+       - `compileGrammar` gives the non-terminals (the keys of the `grammar` map) the ids `0 .. nonTerminalCount - 1` and every other symbol a larger id.
 
     2. **Return True or False**:
-       - If the token is **not** found in the `grammar` map, this implies that the token is a terminal symbol (since non-terminals are keys in the `grammar` map). The function returns `true` to indicate the token is a terminal.
-       - If the token is found in the `grammar` map, it is a non-terminal, and the function returns `false` to indicate the token is not a terminal.
+       - An id outside the non-terminal range is a terminal, and the function returns `true`; otherwise it returns `false`.
 
     Example:
 
     Given the grammar:
     S -> A b A -> a | b
 
-    If the token is `"a"`, the function returns `true` because `"a"` is not a key in the `grammar` map, indicating it's a terminal. Similarly, if the token is `"S"`, the function returns `false` because `"S"` is a non-terminal.
+    `S` and `A` have the ids 0 and 1, so the id of `"a"` (2 or more) is a terminal and the id of `"S"` is not.
 
     </summary>
     */
-    bool isTerminal(const std::string& token)
+    bool isTerminal(int symbol) const
     {
-        return grammar.find(token) == grammar.end();
+        return symbol >= nonTerminalCount;
     }
 
     /* <summary>
-    This function computes and returns a set of all terminals present in the FIRST and FOLLOW sets of the grammar.
+    This function returns the id of a symbol, adding it to the symbol table as a terminal when it is not known yet.
+    </summary> */
+    int internSymbol(const std::string& name)
+    {
+        auto found = symbolIds.emplace(name, static_cast<int>(symbolNames.size()));
+        if (found.second)
+        {
+            symbolNames.push_back(name);
+        }
+        return found.first->second;
+    }
 
-    The function works as follows:
+    /* <summary>
+    This function returns the id of a symbol, or -1 if the grammar does not contain it.
+    </summary> */
+    int symbolId(const std::string& name) const
+    {
+        auto found = symbolIds.find(name);
+        return found == symbolIds.end() ? -1 : found->second;
+    }
+
+    /* <summary>
+    This function formats a row of a terminal set as the names of its terminals in the order of their ids, each followed by a space.
+    </summary> */
+    std::string symbolList(const SymbolSets& sets, size_t row) const
+    {
+        std::string list;
+        sets.forEach(row, [this, &list](size_t column) { list += symbolNames[nonTerminalCount + column] + " "; });
+        return list;
+    }
+
+    /* <summary>
+    This function formats the FIRST set of a non-terminal, with `EPSILON` last when the non-terminal is nullable.
+    </summary> */
+    std::string firstList(int nonTerminal) const
+    {
+        return symbolList(firstSets, nonTerminal) + (nullable[nonTerminal] ? EPSILON + " " : "");
+    }
+
+    /* <summary>
+    This function checks whether a symbol id (-1 for an unknown token) is in the FOLLOW set of a non-terminal.
+    </summary> */
+    bool inFollow(int nonTerminal, int symbol) const
+    {
+        return symbol >= nonTerminalCount && followSets.contains(nonTerminal, static_cast<size_t>(symbol - nonTerminalCount));
+    }
+
+    /* <summary>
+    This function returns the terminals that have an entry in some row of the parse table, sorted by name: the columns of the printed table.
+    </summary> */
+    std::vector<int> parseTableColumns() const
+    {
+        std::vector<int> columns;
+        for (int column = 0; column < tableColumns; ++column)
+        {
+            for (int nonTerminal = 0; nonTerminal < nonTerminalCount; ++nonTerminal)
+            {
+                if (parseTable[static_cast<size_t>(nonTerminal) * tableColumns + column] != errorEntry)
+                {
+                    columns.push_back(nonTerminalCount + column);
+                    break;
+                }
+            }
+        }
+        std::sort(columns.begin(), columns.end(), [this](int a, int b) { return symbolNames[a] < symbolNames[b]; });
+        return columns;
+    }
+
+    /* <summary>
+    This function returns the parse table entry of a non-terminal and a symbol id: a production index, `syncEntry`, or `errorEntry` for a symbol that has no column (an unknown token is -1). It is a single load from the table.
+    </summary> */
+    uint16_t tableEntry(int nonTerminal, int symbol) const
+    {
+        const unsigned column = static_cast<unsigned>(symbol - nonTerminalCount);
+        if (column >= static_cast<unsigned>(tableColumns))
+        {
+            return errorEntry;
+        }
+        return parseTable[static_cast<size_t>(nonTerminal) * tableColumns + column];
+    }
+
+    /* <summary>
+    This function returns the text of a parse table entry as it is printed: the production, "sync", or "-" for an empty cell.
+    </summary> */
+    const std::string& entryText(uint16_t entry) const
+    {
+        static const std::string sync = "sync";
+        static const std::string empty = "-";
+        return entry == syncEntry ? sync : entry == errorEntry ? empty : productionText[entry];
+    }
+
+    /* <summary>
+    This function checks whether a non-terminal has any entry in the parse table; only such rows are printed.
+    </summary> */
+    bool hasTableRow(int nonTerminal) const
+    {
+        const uint16_t* row = parseTable.data() + static_cast<size_t>(nonTerminal) * tableColumns;
+        return std::any_of(row, row + tableColumns, [](uint16_t entry) { return entry != errorEntry; });
+    }
+
+    /* <summary>
+    This function compiles `grammar` into the integer form the FIRST/FOLLOW computation, the parse table and the parser work on, so none of them hashes a symbol name or re-splits a production.
+
+    Logic:
+    1. Give every non-terminal an id, in the order of `grammar`. The start symbol of the FOLLOW computation is the first non-terminal of the grammar file (id 0 if it was removed).
+    2. Split every production into its symbols once and append their ids to `productionSymbols`. A symbol that is not a non-terminal becomes a terminal with the next free id. `EPSILON` and the `^` that `removeLeftRecursion` adds stand for the empty string and are left out, so an epsilon production has no symbols. The productions of a non-terminal are stored next to each other, in the order of its set in `grammar`, so every algorithm visits them in the same order as before.
+       Also append the ids in reverse order to `pushSymbols`, which is what the parser pushes to expand with the production.
+    3. Add the end marker `$` as a terminal and drop the sets and the parse table of the previous grammar.
+    </summary> */
+    void compileGrammar()
+    {
+        symbolNames.clear();
+        symbolIds.clear();
+        for (const auto& entry : grammar)
+        {
+            internSymbol(entry.first);
+        }
+        nonTerminalCount = static_cast<int>(symbolNames.size());
+
+        ruleStart.assign(1, 0);
+        productionStart.assign(1, 0);
+        productionSymbols.clear();
+        productionLhs.clear();
+        productionText.clear();
+        pushStart.assign(1, 0);
+        pushSymbols.clear();
+        int nonTerminal = 0;
+        for (const auto& entry : grammar)
+        {
+            for (const std::string& production : entry.second)
+            {
+                std::istringstream stream(production);
+                std::string token;
+                while (stream >> token)
+                {
+                    if (token != EPSILON && token != "^")
+                    {
+                        productionSymbols.push_back(internSymbol(token));
+                    }
+                }
+                pushSymbols.insert(pushSymbols.end(), productionSymbols.rbegin(), productionSymbols.rend() - productionStart.back());
+                productionStart.push_back(static_cast<int>(productionSymbols.size()));
+                productionLhs.push_back(nonTerminal);
+                productionText.push_back(production);
+                pushStart.push_back(static_cast<int>(pushSymbols.size()));
+            }
+            ruleStart.push_back(static_cast<int>(productionLhs.size()));
+            ++nonTerminal;
+        }
 
-    1. **Create a Set to Store Terminals**:
-       - It initializes an unordered set called `allTerminals` that will store all unique terminal symbols.
+        endSymbol = internSymbol("$");
+        const int start = symbolId(grammarStart);
+        startSymbol = start >= 0 && start < nonTerminalCount ? start : 0;
+        nullable.clear();
+        firstSets.assign(0, 0);
+        followSets.assign(0, 0);
+        suffixFirst.assign(0, 0);
+        suffixNullable.clear();
+        parseTable.clear();
+        tableColumns = 0;
+    }
 
-    2. **Iterate Through FIRST Sets**:
-       - It iterates through all entries in the `firstSets` map. For each entry, it adds all the symbols from the FIRST set (the second element of the map entry) to the `allTerminals` set.
+    /* <summary>
+    This function computes and returns the set of all terminals present in the FIRST and FOLLOW sets of the grammar.
 
-    3. **Iterate Through FOLLOW Sets**:
-       - Similarly, it iterates through all entries in the `followSets` map. Each symbol in the FOLLOW set is added to the `allTerminals` set.
+    The function works as follows:
 
-    4. **Remove EPSILON**:
-       - The function removes the `EPSILON` symbol from the `allTerminals` set, since `EPSILON` is not considered a terminal.
+    1. **Union the Rows**:
+       - It ORs the FIRST set of every non-terminal and then its FOLLOW set into one row, a word at a time.
 
-    5. **Return the Set of Terminals**:
-       - Finally, the function returns the set `allTerminals`, which contains all unique terminals found in the grammar.
+    2. **Return the Set of Terminals**:
+       - Every bit of the row is turned back into its symbol id. `EPSILON` has no column, so it is never part of the result.
 
     Example:
     Given the following sets:
-    FOLLOW(S) = { $ } FOLLOW(A) = { a b } FOLLOW(B) = { c }
+    FIRST(S) = { a } FOLLOW(S) = { $ } FOLLOW(A) = { a b }
 
-
-    5. **Error Handling**:
-       - If the file cannot be opened, an error message is displayed, and the program terminates.
+    The result is { a b $ }.
     </summary>
     */
-    std::unordered_set<std::string> computeAllTerminals()
+    std::unordered_set<int> computeAllTerminals() const
     {
-        std::unordered_set<std::string> allTerminals;
-        for (const auto& entry : firstSets)
-            allTerminals.insert(entry.second.begin(), entry.second.end());
-        for (const auto& entry : followSets)
-            allTerminals.insert(entry.second.begin(), entry.second.end());
-        allTerminals.erase(EPSILON);
+        SymbolSets all;
+        all.assign(1, firstSets.columnCount());
+        for (int nonTerminal = 0; nonTerminal < nonTerminalCount; ++nonTerminal)
+        {
+            all.unite(0, firstSets, nonTerminal);
+            all.unite(0, followSets, nonTerminal);
+        }
+        std::unordered_set<int> allTerminals;
+        all.forEach(0, [this, &allTerminals](size_t column) { allTerminals.insert(nonTerminalCount + static_cast<int>(column)); });
         return allTerminals;
     }
 
@@ -634,231 +936,427 @@ private:
     // |-------------------------------------------------------------------------------------------------------------|
 
     /* <summary>
-    This function computes the FOLLOW set for a given non-terminal in a context-free grammar.
-
-    ### Explanation of the Algorithm:
-
-    1. **Base Case Check**:
-       - If the `nonTerminal` has already been visited (i.e., it is present in the `visited` set) or its FOLLOW set is already computed (i.e., `followSets[nonTerminal].empty()` is `false`), the function simply returns to avoid redundant work.
-
-    2. **Mark Non-Terminal as Visited**:
-       - The `nonTerminal` is inserted into the `visited` set to prevent recalculating its FOLLOW set during recursive calls.
-
-    3. **Add '$' to FOLLOW of the Start Symbol**:
-       - The start symbol (first non-terminal in the grammar) has `"$"` (indicating end of input) in its FOLLOW set. This is a standard rule in context-free grammars.
-
-    4. **Iterate Through Grammar Productions**:
-       - The function iterates over all productions in the grammar to find occurrences of the `nonTerminal` in the right-hand side (RHS) of the productions.
-       - For each production, the tokens are split and analyzed to determine if the `nonTerminal` is present.
-
-    5. **Processing Productions**:
-       - If the `nonTerminal` is found in a production, the function looks at the tokens that follow it:
-         - If the next token is a **terminal**, it is directly added to the FOLLOW set of the `nonTerminal`, and the processing for this production stops.
-         - If the next token is a **non-terminal**, the FIRST set of that non-terminal is added to the FOLLOW set of the `nonTerminal`. The function also removes `"NULL"` (representing epsilon) from the set.
-         - If the next token can derive the empty string (i.e., if its FIRST set contains `"NULL"`), the function continues to the next token in the production.
-
-    6. **Handling Nullable Productions**:
-       - If all the tokens after the `nonTerminal` in the production can derive the empty string (i.e., they are nullable), the function recursively computes the FOLLOW set for the left-hand side (`LHS`) of the production and adds the FOLLOW set of the `LHS` to the FOLLOW set of the `nonTerminal`.
-
-    7. **Recursive Call**:
-       - If the FOLLOW set of the `nonTerminal` depends on the FOLLOW set of another non-terminal (`LHS`), a recursive call to `computeFollow` is made to compute the FOLLOW set of the `LHS`.
-
-    ### Example Walkthrough:
-
-    Given the following grammar:
-    S -> A B A -> a | NULL B -> b
-
-    - **FOLLOW(S)**:
-      - Since `S` is the start symbol, its FOLLOW set will contain `"$"`.
-
-    - **FOLLOW(A)**:
-      - `A` is found in `S -> A B`. Since `B` follows `A` and `B` is a terminal (`b`), `b` is added to the FOLLOW set of `A`.
-      - Thus, `FOLLOW(A)` will be `{b}`.
-
-    - **FOLLOW(B)**:
-      - `B` is the last token in the production `S -> A B`, so `FOLLOW(B)` will include `FOLLOW(S)`, which is `"$"`.
-      - Thus, `FOLLOW(B)` will be `{"$"}`.
-
-    ### Complexity:
-    - The function iterates through all grammar productions and applies the rules for computing the FOLLOW set. It may make recursive calls, so the complexity depends on the size of the grammar and the recursive depth required to compute FOLLOW sets.
+    This function starts the worker threads of the FIRST/FOLLOW and parse table construction. It returns none, and the work runs on the calling thread, when one thread is set or the compiled grammar has fewer than `minParallelNonTerminals` non-terminals, as starting threads would cost more than they save.
+    </summary> */
+    std::unique_ptr<ThreadPool> startWorkers() const
+    {
+        if (threadCount < 2 || nonTerminalCount < minParallelNonTerminals)
+        {
+            return nullptr;
+        }
+        return std::make_unique<ThreadPool>(threadCount);
+    }
 
-    </summary>
-    */
-    void computeFollow(const std::string& nonTerminal, std::unordered_set<std::string>& visited)
+    /* <summary>
+    This function runs `body(begin, end)` over `0 .. count` and returns when it is done: split into about four ranges per worker of `pool`, or as one range on the calling thread without a pool or when the ranges would have fewer than `minRange` items. The ranges must not write to the same data.
+    </summary> */
+    template <typename Body>
+    static void forRanges(ThreadPool* pool, size_t count, size_t minRange, Body body)
     {
-        // If already visited or follow set computed, return
-        if (visited.count(nonTerminal) || !followSets[nonTerminal].empty()) 
+        const size_t ranges = pool ? std::min(pool->size() * 4, count / minRange) : 1;
+        if (ranges < 2)
         {
+            body(size_t(0), count);
             return;
         }
+        std::vector<std::future<void>> done;
+        done.reserve(ranges);
+        for (size_t range = 0; range < ranges; ++range)
+        {
+            const size_t begin = count * range / ranges;
+            const size_t end = count * (range + 1) / ranges;
+            done.push_back(pool->submit([&body, begin, end]() { body(begin, end); }));
+        }
+        for (std::future<void>& range : done)
+        {
+            range.get();
+        }
+    }
 
-        visited.insert(nonTerminal);
+    /* <summary>
+    This function propagates set rows along edges to the least fixed point: for every edge `from -> to`, row `to` of `sets` ends up containing row `from`. It is the fixed-point step of both `computeFirst` (FIRST(B) flows into FIRST(A)) and `computeFollow` (FOLLOW(A) flows into FOLLOW(B)).
 
-        // Add "$" to FOLLOW set of the start symbol
-        if (nonTerminal == grammar.begin()->first) 
+    Logic:
+    1. Sort the edges by their target, so every row knows the rows that flow into it (its sources).
+    2. Split the rows into strongly connected components with Tarjan's algorithm (iteratively, so long chains of non-terminals cannot overflow the call stack). Tarjan's algorithm completes a component only after every component it depends on, so the components come out in dependency order.
+    3. All rows of a component reach each other, so at the fixed point they hold the same set: the union of their own rows and of all sources outside the component. A component is solved in one pass, by ORing that union into its first row and copying it to the others; no row is visited twice and the cost is edges × terminals / 64 word operations.
+    4. A component's level is one more than the highest level of the components it depends on. The components of one level only read rows of lower levels, so each level is solved in parallel on `pool` (`forRanges`), one level after the other.
+    5. The fixed point is unique, so the sets are the same for every number of threads and every order of the grammar.
+    </summary> */
+    static void propagate(SymbolSets& sets, int rows, const std::vector<std::pair<int, int>>& edges, ThreadPool* pool)
+    {
+        std::vector<int> sourceStart(rows + 1, 0);
+        for (const auto& edge : edges)
         {
-            followSets[nonTerminal].insert("$");
+            ++sourceStart[edge.second + 1];
         }
-
-        for (std::unordered_map<std::string, std::unordered_set<std::string>>::iterator it = grammar.begin(); it != grammar.end(); ++it)
+        for (int row = 0; row < rows; ++row)
+        {
+            sourceStart[row + 1] += sourceStart[row];
+        }
+        std::vector<int> sources(edges.size());
+        std::vector<int> fill(sourceStart.begin(), sourceStart.end() - 1);
+        for (const auto& edge : edges)
         {
-            const std::string& lhs = it->first;
-            const std::unordered_set<std::string>& productions = it->second;
+            sources[fill[edge.second]++] = edge.first;
+        }
 
-            for (std::unordered_set<std::string>::iterator prodIt = productions.begin(); prodIt != productions.end(); ++prodIt)
+        // Tarjan's algorithm over row -> source; component c is members[memberStart[c] .. memberStart[c + 1])
+        std::vector<int> order(rows, -1);
+        std::vector<int> low(rows, 0);
+        std::vector<int> component(rows, -1);
+        std::vector<int> members;
+        std::vector<int> memberStart(1, 0);
+        std::vector<int> level;
+        std::vector<int> path;
+        std::vector<std::pair<int, int>> calls; // a row and its next source edge
+        int visited = 0;
+        for (int root = 0; root < rows; ++root)
+        {
+            if (order[root] >= 0)
             {
-                const std::string& production = *prodIt;
-                std::istringstream stream(production);
-                std::vector<std::string> tokens;
-                std::string token;
-                while (stream >> token) {
-                    tokens.push_back(token);
+                continue;
+            }
+            order[root] = low[root] = visited++;
+            path.push_back(root);
+            calls.emplace_back(root, sourceStart[root]);
+            while (!calls.empty())
+            {
+                const int row = calls.back().first;
+                if (calls.back().second < sourceStart[row + 1])
+                {
+                    const int source = sources[calls.back().second++];
+                    if (order[source] < 0)
+                    {
+                        order[source] = low[source] = visited++;
+                        path.push_back(source);
+                        calls.emplace_back(source, sourceStart[source]);
+                    }
+                    else if (component[source] < 0)
+                    {
+                        low[row] = std::min(low[row], order[source]);
+                    }
+                    continue;
                 }
 
-                for (size_t i = 0; i < tokens.size(); ++i) 
+                calls.pop_back();
+                if (!calls.empty())
+                {
+                    low[calls.back().first] = std::min(low[calls.back().first], low[row]);
+                }
+                if (low[row] != order[row])
+                {
+                    continue;
+                }
+                const int current = static_cast<int>(level.size());
+                int member;
+                do
+                {
+                    member = path.back();
+                    path.pop_back();
+                    component[member] = current;
+                    members.push_back(member);
+                } while (member != row);
+                memberStart.push_back(static_cast<int>(members.size()));
+
+                int depth = 0;
+                for (int at = memberStart[current]; at < memberStart[current + 1]; ++at)
                 {
-                    if (tokens[i] == nonTerminal) 
+                    for (int edge = sourceStart[members[at]]; edge < sourceStart[members[at] + 1]; ++edge)
                     {
-                        bool addFollowOfLHS = true;
-
-                        // Add FIRST of the following tokens to FOLLOW(nonTerminal)
-                        for (size_t j = i + 1; j < tokens.size(); ++j) 
+                        if (component[sources[edge]] != current)
                         {
-                            const std::string& nextToken = tokens[j];
-                            if (grammar.find(nextToken) == grammar.end()) 
-                            {
-                                followSets[nonTerminal].insert(nextToken); // Terminal
-                                addFollowOfLHS = false;
-                                break;
-                            }
-
-                            followSets[nonTerminal].insert(firstSets[nextToken].begin(), firstSets[nextToken].end());
-                            followSets[nonTerminal].erase("NULL");
-
-                            if (!firstSets[nextToken].count("NULL")) 
-                            {
-                                addFollowOfLHS = false;
-                                break;
-                            }
+                            depth = std::max(depth, level[component[sources[edge]]] + 1);
                         }
+                    }
+                }
+                level.push_back(depth);
+            }
+        }
 
-                        // If all subsequent tokens can derive NULL, add FOLLOW(LHS)
-                        if (addFollowOfLHS) 
-                        {
-                            computeFollow(lhs, visited);
-                            followSets[nonTerminal].insert(followSets[lhs].begin(), followSets[lhs].end());
-                        }
+        // Components by level
+        const int componentCount = static_cast<int>(level.size());
+        const int levelCount = componentCount == 0 ? 0 : *std::max_element(level.begin(), level.end()) + 1;
+        std::vector<int> levelStart(levelCount + 1, 0);
+        for (int depth : level)
+        {
+            ++levelStart[depth + 1];
+        }
+        for (int depth = 0; depth < levelCount; ++depth)
+        {
+            levelStart[depth + 1] += levelStart[depth];
+        }
+        std::vector<int> byLevel(componentCount);
+        fill.assign(levelStart.begin(), levelStart.end() - 1);
+        for (int current = 0; current < componentCount; ++current)
+        {
+            byLevel[fill[level[current]]++] = current;
+        }
+
+        const auto solve = [&](int current)
+        {
+            const int first = members[memberStart[current]];
+            for (int at = memberStart[current]; at < memberStart[current + 1]; ++at)
+            {
+                const int member = members[at];
+                if (member != first)
+                {
+                    sets.unite(first, sets, member);
+                }
+                for (int edge = sourceStart[member]; edge < sourceStart[member + 1]; ++edge)
+                {
+                    if (component[sources[edge]] != current)
+                    {
+                        sets.unite(first, sets, sources[edge]);
                     }
                 }
             }
+            for (int at = memberStart[current] + 1; at < memberStart[current + 1]; ++at)
+            {
+                sets.unite(members[at], sets, first);
+            }
+        };
+        for (int depth = 0; depth < levelCount; ++depth)
+        {
+            const int* components = byLevel.data() + levelStart[depth];
+            forRanges(pool, levelStart[depth + 1] - levelStart[depth], 64, [&solve, components](size_t begin, size_t end)
+            {
+                for (size_t at = begin; at < end; ++at)
+                {
+                    solve(components[at]);
+                }
+            });
         }
     }
 
     /* <summary>
-    This function computes the FIRST set for a given non-terminal in a context-free grammar.
+    This function computes which non-terminals are nullable (derive ε), the FIRST set of every non-terminal, and the FIRST set of every production suffix.
 
     ### Explanation of the Algorithm:
 
-    1. **Base Case Check**:
-       - If the `nonTerminal` has already been visited (i.e., it is present in the `visited` set) or its FIRST set is already computed (i.e., `firstSets[nonTerminal].empty()` is `false`), the function simply returns, preventing redundant work and infinite recursion.
-
-    2. **Mark Non-Terminal as Visited**:
-       - The `nonTerminal` is inserted into the `visited` set to avoid recalculating its FIRST set during recursive calls.
-
-    3. **Process Productions**:
-       - The function iterates over all the productions for the `nonTerminal` in the grammar. Each production is treated as a sequence of tokens.
-       - A stream (`std::istringstream`) is used to break the production into individual tokens.
+    1. **Nullable Non-Terminals**:
+       - Every production counts its symbols that are not known to be nullable yet; a production without symbols (ε) starts at 0.
+       - A production whose count reaches 0 makes its left-hand side nullable. The new nullable non-terminal goes on a worklist, and taking it off decrements the count of every production it occurs in (once per occurrence).
+       - Terminals are never nullable, so a production with a terminal never reaches 0.
 
-    4. **Handling Tokens in the Production**:
-       - The function checks each token in the production to determine if it is a terminal or another non-terminal:
-         - If the token is a **terminal**, it is directly added to the FIRST set of the `nonTerminal`, and the loop is terminated (since a terminal symbol is the first symbol of a production).
-         - If the token is a **non-terminal**, the function recursively computes the FIRST set for that non-terminal by calling `computeFirst` for the token. The FIRST set of the token is then added to the FIRST set of the `nonTerminal`.
+    2. **FIRST Sets**:
+       - For a production `A -> X1 X2 ... Xn`, walk the symbols while the ones before are nullable. A terminal `Xi` is put into FIRST(A) directly, and the walk stops. A non-terminal `Xi` adds the edge `Xi -> A` (FIRST(Xi) flows into FIRST(A)), and the walk stops unless `Xi` is nullable.
+       - `propagate` then solves the edges one strongly connected component at a time, so mutually recursive non-terminals get all of each other's terminals, in any order.
+       - The suffixes of different productions are independent and are computed in parallel when `pool` is given.
 
-    5. **Nullable Tokens**:
-       - If the token is a non-terminal and its FIRST set contains `"NULL"` (representing epsilon, i.e., the empty string), the current non-terminal's production can derive the empty string, making it **nullable**. If a nullable non-terminal is encountered, the algorithm continues to process the next token in the production.
+    3. **FIRST of the Production Suffixes**:
+       - Every production is walked backwards. The empty suffix at the end is nullable with no terminals; the suffix starting at `Xi` is `{ Xi }` for a terminal, and FIRST(Xi) plus, if `Xi` is nullable, the suffix after it for a non-terminal.
+       - The suffix starting at the first symbol is the FIRST set of the whole production, which the parse table uses; the suffixes after each symbol give the FOLLOW sets.
 
-    6. **Epsilon Production**:
-       - If a production can derive the empty string (i.e., nullable), `"NULL"` is added to the FIRST set of the `nonTerminal`.
+    4. **Representation**:
+       - The sets are bit rows over the terminals (`SymbolSets`), so a union is a few word ORs. `EPSILON` is not a terminal; nullability is kept in `nullable` and `suffixNullable` instead.
 
-    ### Example Walkthrough:
+    ### Example:
 
-    - Suppose we have the following grammar:
-        ```
-        S -> A B
-        A -> a | NULL
-        B -> b
-        ```
-
-    - **First Set Calculation**:
-        - `FIRST(S)`:
-            - `S`'s production is `A B`.
-            - `A` is processed, which can derive `a` and `NULL`.
-            - Since `A` can be `NULL`, the function moves to `B` and adds `b` to `FIRST(S)`.
-            - Thus, `FIRST(S)` will be `{a, b}`.
-        - `FIRST(A)`:
-            - `A`'s production is `a` or `NULL`.
-            - `FIRST(A)` will be `{a, NULL}`.
-        - `FIRST(B)`:
-            - `B`'s production is `b`.
-            - `FIRST(B)` will be `{b}`.
+    Given the grammar:
+    S -> A B
+    A -> a | ε
+    B -> b
 
-    </summary>
-    */
-    void computeFirst(const std::string& nonTerminal, std::unordered_set<std::string>& visited)
+    - `A` is nullable; `S` and `B` are not.
+    - FIRST(A) = { a }, FIRST(B) = { b }, and the edges `A -> S` and, because `A` is nullable, `B -> S` give FIRST(S) = { a b }.
+    - The suffixes of `S -> A B` are `A B` = { a b }, `B` = { b } and the empty suffix, which is nullable.
+    </summary> */
+    void computeFirst(ThreadPool* pool)
     {
-        if (visited.count(nonTerminal) || !firstSets[nonTerminal].empty()) 
-            return;
-
-        visited.insert(nonTerminal);
+        const int productionCount = static_cast<int>(productionLhs.size());
+        const size_t terminalCount = symbolNames.size() - nonTerminalCount;
 
-        for (const auto& production : grammar[nonTerminal]) 
+        // Where every non-terminal occurs
+        positionProduction.resize(productionSymbols.size());
+        occurrenceStart.assign(nonTerminalCount + 1, 0);
+        for (int symbol : productionSymbols)
         {
-            std::istringstream stream(production);
-            std::string token;
-            bool nullable = true;
+            if (!isTerminal(symbol))
+            {
+                ++occurrenceStart[symbol + 1];
+            }
+        }
+        for (int nonTerminal = 0; nonTerminal < nonTerminalCount; ++nonTerminal)
+        {
+            occurrenceStart[nonTerminal + 1] += occurrenceStart[nonTerminal];
+        }
+        occurrences.resize(occurrenceStart.back());
+        std::vector<int> fill(occurrenceStart.begin(), occurrenceStart.end() - 1);
+        for (int production = 0; production < productionCount; ++production)
+        {
+            for (int at = productionStart[production]; at < productionStart[production + 1]; ++at)
+            {
+                positionProduction[at] = production;
+                if (!isTerminal(productionSymbols[at]))
+                {
+                    occurrences[fill[productionSymbols[at]]++] = at;
+                }
+            }
+        }
 
-            while (nullable && stream >> token) 
+        // Nullable non-terminals
+        nullable.assign(nonTerminalCount, 0);
+        std::vector<int> remaining(productionCount);
+        std::vector<int> worklist;
+        for (int production = 0; production < productionCount; ++production)
+        {
+            remaining[production] = productionStart[production + 1] - productionStart[production];
+            if (remaining[production] == 0 && !nullable[productionLhs[production]])
+            {
+                nullable[productionLhs[production]] = 1;
+                worklist.push_back(productionLhs[production]);
+            }
+        }
+        while (!worklist.empty())
+        {
+            const int symbol = worklist.back();
+            worklist.pop_back();
+            for (int occurrence = occurrenceStart[symbol]; occurrence < occurrenceStart[symbol + 1]; ++occurrence)
             {
-                nullable = false;
+                const int production = positionProduction[occurrences[occurrence]];
+                if (--remaining[production] == 0 && !nullable[productionLhs[production]])
+                {
+                    nullable[productionLhs[production]] = 1;
+                    worklist.push_back(productionLhs[production]);
+                }
+            }
+        }
 
-                if (isTerminal(token)) 
+        // FIRST sets: the terminals that can start a production, and the non-terminals whose FIRST set flows in
+        firstSets.assign(nonTerminalCount, terminalCount);
+        std::vector<std::pair<int, int>> edges;
+        for (int production = 0; production < productionCount; ++production)
+        {
+            const int lhs = productionLhs[production];
+            for (int at = productionStart[production]; at < productionStart[production + 1]; ++at)
+            {
+                const int symbol = productionSymbols[at];
+                if (isTerminal(symbol))
                 {
-                    firstSets[nonTerminal].insert(token);
+                    firstSets.insert(lhs, symbol - nonTerminalCount);
                     break;
                 }
-
-                computeFirst(token, visited);
-                firstSets[nonTerminal].insert(firstSets[token].begin(), firstSets[token].end());
-                if (firstSets[token].count("NULL"))
+                edges.emplace_back(symbol, lhs);
+                if (!nullable[symbol])
                 {
-                    nullable = true;
-                    firstSets[nonTerminal].erase("NULL");
+                    break;
                 }
             }
-
-            if (nullable) firstSets[nonTerminal].insert("NULL");
         }
-    }
+        propagate(firstSets, nonTerminalCount, edges, pool);
 
-    // |-------------------------------------------------------------------------------------------------------------|
-    // |                                              Output Functions                                               |
-    // |-------------------------------------------------------------------------------------------------------------|
+        // FIRST of every production suffix, from the end of the production backwards; productions are independent
+        suffixFirst.assign(productionSymbols.size() + productionCount, terminalCount);
+        suffixNullable.assign(productionSymbols.size() + productionCount, 0);
+        forRanges(pool, productionCount, 256, [this](size_t begin, size_t end)
+        {
+            for (int production = static_cast<int>(begin); production < static_cast<int>(end); ++production)
+            {
+                const int last = productionStart[production + 1];
+                suffixNullable[last + production] = 1;
+                for (int at = last - 1; at >= productionStart[production]; --at)
+                {
+                    const int row = at + production;
+                    const int symbol = productionSymbols[at];
+                    if (isTerminal(symbol))
+                    {
+                        suffixFirst.insert(row, symbol - nonTerminalCount);
+                        continue;
+                    }
+                    suffixFirst.unite(row, firstSets, symbol);
+                    if (nullable[symbol])
+                    {
+                        suffixFirst.unite(row, suffixFirst, row + 1);
+                        suffixNullable[row] = suffixNullable[row + 1];
+                    }
+                }
+            }
+        });
+    }
 
     /* <summary>
-    This function prints the FOLLOW sets of all non-terminals in the grammar to a file named "FollowSet.txt".
+    This function computes the FOLLOW sets of all non-terminals. It needs the FIRST sets of the production suffixes from `computeFirst`.
 
-    The function operates as follows:
+    ### Explanation of the Algorithm:
 
-    1. **Open the File**:
-       - It opens a file named `FollowSet.txt` in write mode. If the file cannot be opened, an error message is printed to the standard error stream, and the program exits.
+    1. **Start Symbol**:
+       - The end marker `$` is put into the FOLLOW set of the start symbol.
 
-    2. **Iterate Through the FOLLOW Sets**:
-       - The function loops through the `followSets` data structure, which is a map where the key is a non-terminal, and the value is a set of strings representing the FOLLOW set of that non-terminal.
+    2. **Processing Productions**:
+       - For every occurrence of a non-terminal `B` in a production `A -> α B β`, the FIRST set of the suffix `β` is added to FOLLOW(B). It already contains the terminals of everything nullable after `B`, so no production is walked twice. The occurrences are indexed per non-terminal (`computeFirst`), so every non-terminal fills only its own row, in parallel when `pool` is given.
+       - If `β` is nullable (or empty), whatever follows `A` also follows `B`, which is the edge `A -> B`.
 
-    3. **Print Each FOLLOW Set**:
-       - For each non-terminal, the function writes the FOLLOW set to the file in the following format:
-         - `FOLLOW(non-terminal) = { ... }` where the non-terminal is the key, and the set of FOLLOW symbols is printed inside curly braces `{}`.
-       - Each symbol in the FOLLOW set is separated by a space.
+    3. **Fixed Point**:
+       - `propagate` solves the edges in dependency order, one strongly connected component at a time, so FOLLOW sets that depend on each other in a cycle are complete, and the result does not depend on the order of the non-terminals.
+
+    ### Example Walkthrough:
+
+    Given the following grammar:
+    S -> A B
+    A -> a | ε
+    B -> b | ε
+
+    - FOLLOW(S) = { $ }.
+    - In `S -> A B`, FIRST(B) = { b } is added to FOLLOW(A), and `B` is nullable, so there is an edge `S -> A`. `B` is last, so there is an edge `S -> B`.
+    - After propagation: FOLLOW(A) = { b $ }, FOLLOW(B) = { $ }.
+    </summary> */
+    void computeFollow(ThreadPool* pool)
+    {
+        followSets.assign(nonTerminalCount, symbolNames.size() - nonTerminalCount);
+        if (nonTerminalCount > 0)
+        {
+            followSets.insert(startSymbol, endSymbol - nonTerminalCount);
+        }
+
+        // The suffixes after the occurrences of every non-terminal; each non-terminal only writes its own row
+        forRanges(pool, nonTerminalCount, 64, [this](size_t begin, size_t end)
+        {
+            for (int symbol = static_cast<int>(begin); symbol < static_cast<int>(end); ++symbol)
+            {
+                for (int occurrence = occurrenceStart[symbol]; occurrence < occurrenceStart[symbol + 1]; ++occurrence)
+                {
+                    const int at = occurrences[occurrence];
+                    followSets.unite(symbol, suffixFirst, at + 1 + positionProduction[at]);
+                }
+            }
+        });
+
+        std::vector<std::pair<int, int>> edges;
+        for (int symbol = 0; symbol < nonTerminalCount; ++symbol)
+        {
+            for (int occurrence = occurrenceStart[symbol]; occurrence < occurrenceStart[symbol + 1]; ++occurrence)
+            {
+                const int at = occurrences[occurrence];
+                const int lhs = productionLhs[positionProduction[at]];
+                if (suffixNullable[at + 1 + positionProduction[at]] && symbol != lhs)
+                {
+                    edges.emplace_back(lhs, symbol);
+                }
+            }
+        }
+        propagate(followSets, nonTerminalCount, edges, pool);
+    }
+
+    // |-------------------------------------------------------------------------------------------------------------|
+    // |                                              Output Functions                                               |
+    // |-------------------------------------------------------------------------------------------------------------|
+
+    /* <summary>
+    This function prints the FOLLOW sets of all non-terminals in the grammar to a file named "FollowSet.txt".
+
+    The function operates as follows:
+
+    1. **Open the File**:
+       - It opens a file named `FollowSet.txt` in write mode. If the file cannot be opened, an error message is printed to the standard error stream, and the program exits.
+
+    2. **Iterate Through the FOLLOW Sets**:
+       - The function loops through the non-terminals in the order of their ids; `followSets` holds the FOLLOW set of each as a row of terminal bits.
+
+    3. **Print Each FOLLOW Set**:
+       - For each non-terminal, the function writes the FOLLOW set to the file in the following format:
+         - `FOLLOW(non-terminal) = { ... }` where the non-terminal is the key, and the set of FOLLOW symbols is printed inside curly braces `{}`.
+       - Each symbol in the FOLLOW set is separated by a space, in the order of the symbol ids.
 
     4. **File Closing**:
        - After all FOLLOW sets are written, the function closes the file.
@@ -878,16 +1376,9 @@ private:
             std::cerr << "Error: Unable to open FollowSet File." << std::endl;
             exit(1);
         }
-        for (std::unordered_map<std::string, std::unordered_set<std::string>>::iterator it = followSets.begin(); it != followSets.end(); ++it)
+        for (int nonTerminal = 0; nonTerminal < nonTerminalCount; ++nonTerminal)
         {
-            const std::string& nonTerminal = it->first;
-            const std::unordered_set<std::string>& followSet = it->second;
-            followSetFile << "FOLLOW(" << nonTerminal << ") = { ";
-            for (std::unordered_set<std::string>::iterator setIt = followSet.begin(); setIt != followSet.end(); ++setIt)
-            {
-                followSetFile << *setIt << " ";
-            }
-            followSetFile << "}\n";
+            followSetFile << "FOLLOW(" << symbolNames[nonTerminal] << ") = { " << symbolList(followSets, nonTerminal) << "}\n";
         }
         followSetFile.close();
     }
@@ -901,12 +1392,12 @@ private:
        - The function opens a file named `FirstSet.txt` in write mode. If the file cannot be opened, an error message is printed to the standard error stream, and the program exits.
 
     2. **Iterate Through the FIRST Sets**:
-       - The function loops through the `firstSets` data structure, which is a map where the key is a non-terminal, and the value is a set of strings representing the FIRST set of that non-terminal.
+       - The function loops through the non-terminals in the order of their ids; `firstSets` holds the FIRST set of each as a row of terminal bits, and `nullable` whether it derives ε.
 
     3. **Print Each FIRST Set**:
        - For each non-terminal, the function writes the FIRST set to the file in the following format:
          - `FIRST(non-terminal) = { ... }` where the non-terminal is the key, and the set of FIRST symbols is printed inside curly braces `{}`.
-       - Each symbol in the FIRST set is separated by a space.
+       - Each symbol in the FIRST set is separated by a space, in the order of the symbol ids, followed by `ε` for a nullable non-terminal.
 
     4. **File Closing**:
        - Once all FIRST sets have been written, the function closes the file.
@@ -925,16 +1416,9 @@ private:
             std::cerr << "Error: Unable to open FirstSet File." << std::endl;
             exit(1);
         }
-        for (std::unordered_map<std::string, std::unordered_set<std::string>>::iterator it = firstSets.begin(); it != firstSets.end(); ++it)
+        for (int nonTerminal = 0; nonTerminal < nonTerminalCount; ++nonTerminal)
         {
-            const std::string& nonTerminal = it->first;
-            const std::unordered_set<std::string>& firstSet = it->second;
-            firstSetFile << "FIRST(" << nonTerminal << ") = { ";
-            for (std::unordered_set<std::string>::iterator setIt = firstSet.begin(); setIt != firstSet.end(); ++setIt)
-            {
-                firstSetFile << *setIt << " ";
-            }
-            firstSetFile << "}\n";
+            firstSetFile << "FIRST(" << symbolNames[nonTerminal] << ") = { " << firstList(nonTerminal) << "}\n";
         }
         firstSetFile.close();
     }
@@ -969,23 +1453,100 @@ private:
     </summary> */
     void printGrammar()
     {
-        std::cout << "Grammar Contents:" << std::endl;
+        std::ostringstream output;
+        output << "Grammar Contents:" << std::endl;
         for (const auto& entry : grammar)
         {
             const std::string& nonTerminal = entry.first;
             const std::unordered_set<std::string>& productions = entry.second;
 
-            std::cout << nonTerminal << " -> ";
+            output << nonTerminal << " -> ";
             bool first = true;
             for (const auto& production : productions)
             {
-                if (!first) std::cout << " | ";
-                std::cout << production;
+                if (!first) output << " | ";
+                output << production;
                 first = false;
             }
-            std::cout << std::endl;
+            output << std::endl;
         }
-        std::cout << std::endl << std::endl;
+        output << std::endl << std::endl;
+        log(Verbosity::Verbose, output.str());
+    }
+
+    /* <summary>
+    This function writes text to the diagnostic sink if the verbosity is at least `level`.
+    </summary> */
+    void log(Verbosity level, const std::string& text)
+    {
+        if (verbosity >= level)
+        {
+            sink->write(text);
+            sink->flush();
+        }
+    }
+
+    /* <summary>
+    This function opens the files the parsing functions write to.
+
+    Logic:
+    1. Open the "error.txt" file in append mode for logging errors. If the file cannot be opened, print an error message to the console and terminate the program.
+    2. Open the "ParsingProcess.txt" file to log the detailed parsing process. If it fails, log the error in the "error.txt" file and terminate.
+    3. Open the "ParseTree.txt" file to record the parse tree. Handle any opening failure similarly.
+    4. Files whose artifact is disabled (`setArtifact`) are not opened; writes to them are skipped.
+    5. At `Verbosity::Verbose`, attach the buffered console log to the diagnostic sink, and reset the input counters.
+    </summary> */
+    void openParsingFiles()
+    {
+        if (artifacts.enabled(Artifact::ErrorFile))
+        {
+            errorFile.open("error.txt", std::ios::app);
+            if (!errorFile)
+            {
+                std::cerr << "Error: Unable to open error File." << std::endl;
+                exit(1);
+            }
+            errorFile << "\n\n Synthethic Errors from parsing \n\n";
+        }
+        if (artifacts.enabled(Artifact::ParsingProcess))
+        {
+            parsingFile.open("ParsingProcess.txt");
+            if (!parsingFile)
+            {
+                std::cerr << "Error: Unable to open ParsingProcess File." << std::endl;
+                errorFile << "Error: Unable to open ParsingProcess File." << std::endl;
+
+                exit(1);
+            }
+        }
+        if (artifacts.enabled(Artifact::ParseTree))
+        {
+            parsingTree.open("ParseTree.txt");
+            if (!parsingTree)
+            {
+                std::cerr << "Error: Unable to open ParseTree File." << std::endl;
+                errorFile << "Error: Unable to open ParseTree File." << std::endl;
+                exit(1);
+            }
+        }
+        if (verbosity == Verbosity::Verbose)
+        {
+            console.attach(*sink);
+        }
+        parsedInputs = 0;
+        failedInputs = 0;
+    }
+
+    /* <summary>
+    This function closes the files opened by `openParsingFiles`, flushes the console log and, at `Verbosity::Summary` and above, logs one line with the number of parsed and failed inputs.
+    </summary> */
+    void closeParsingFiles()
+    {
+        parsingFile.close();
+        parsingTree.close();
+        errorFile.close();
+        console.close();
+        log(Verbosity::Summary, "Parsing done. " + std::to_string(parsedInputs) + " inputs parsed, " + std::to_string(failedInputs) + " failed.\n");
     }
 
     // |-------------------------------------------------------------------------------------------------------------------------------|
@@ -1001,6 +1562,43 @@ public:
     // |                                             Core Functions                                                  |
     // |-------------------------------------------------------------------------------------------------------------|
 
+    /* <summary>
+    This function turns one parsing artifact on or off: `Artifact::ParsingProcess` ("ParsingProcess.txt"), `Artifact::ParseTree` ("ParseTree.txt") or `Artifact::ErrorFile` (the syntax errors appended to "error.txt"). All are on by default; a disabled file is neither opened nor written, and the parsing steps are not even formatted when no artifact and no console log needs them.
+    </summary> */
+    void setArtifact(Artifact artifact, bool enabled)
+    {
+        artifacts.set(artifact, enabled);
+    }
+
+    /* <summary>
+    This function sets how much the analyzer logs to the diagnostic sink.
+
+    Logic:
+    1. `Verbosity::Verbose` (the default) logs the grammar, the FIRST/FOLLOW table, and every parsing step and parse tree.
+    2. `Verbosity::Summary` logs only the grammar checks and one line per parsing run.
+    3. `Verbosity::Quiet` logs nothing. `printParseTable` still prints, as it is an explicit request, and errors that stop the program still go to `std::cerr`.
+    </summary> */
+    void setVerbosity(Verbosity level)
+    {
+        verbosity = level;
+    }
+
+    /* <summary>
+    This function sets the number of worker threads `computeFirstAndFollow` and `buildParseTable` use for a grammar with at least `minParallelNonTerminals` non-terminals. The default is the number of hardware threads; 0 and 1 keep all work on the calling thread. The results are the same for every count.
+    </summary> */
+    void setThreadCount(unsigned count)
+    {
+        threadCount = count;
+    }
+
+    /* <summary>
+    This function redirects the log from `std::cout` to another sink. The sink must outlive the calls that use it.
+    </summary> */
+    void setDiagnosticSink(DiagnosticSink& target)
+    {
+        sink = &target;
+    }
+
     //
     /*<summary>
     This function loads a context-free grammar (CFG) from a file into a data structure for further processing.
@@ -1023,6 +1621,7 @@ public:
 
     4. **Store the Grammar**:
        - The extracted non-terminal and its corresponding productions are stored in the `grammar` data structure. The grammar is assumed to be stored as a map of non-terminals to their corresponding productions.
+       - The first non-terminal that is read is remembered as the start symbol (`grammarStart`); the map does not keep the order of the file.
 
     5. **Close the File**:
        - After all lines are processed, the file is closed.
@@ -1049,6 +1648,10 @@ public:
                 std::string nonTerminal = line.substr(0, pos - 1);
                 std::string production = line.substr(pos + 2);
                 grammar[nonTerminal] = splitProductions(production);
+                if (grammarStart.empty())
+                {
+                    grammarStart = nonTerminal;
+                }
             }
         }
         file.close();
@@ -1089,16 +1692,16 @@ public:
             const std::string& nonTerminal = it->first;
             if (hasLeftFactoring(grammar)) 
             {
-                std::cout << "Left factoring detected in: " << nonTerminal << std::endl;
+                log(Verbosity::Summary, "Left factoring detected in: " + nonTerminal + "\n");
                 removeLeftFactoring(grammar);
                 leftFactoringFound = hasLeftFactoring(grammar);
                 if (leftFactoringFound)
                 {
-                    std::cout << "Left factoring detected after removal: " << nonTerminal << std::endl;
+                    log(Verbosity::Summary, "Left factoring detected after removal: " + nonTerminal + "\n");
                 }
                 else
                 {
-                    std::cout << "Left factoring not detected after removal: " << nonTerminal << std::endl;
+                    log(Verbosity::Summary, "Left factoring not detected after removal: " + nonTerminal + "\n");
                 }
             }
         }
@@ -1108,27 +1711,27 @@ public:
             const std::string& nonTerminal = it->first;
             if (hasLeftRecursion(grammar)) 
             {
-                std::cout << "Left recursion detected in: " << nonTerminal << std::endl;
+                log(Verbosity::Summary, "Left recursion detected in: " + nonTerminal + "\n");
                 removeLeftRecursion(grammar);
                 leftRecursionFound = hasLeftRecursion(grammar);
                 if (leftRecursionFound)
                 {
-                    std::cout << "Left Recursion detected after removal: " << nonTerminal << std::endl;
+                    log(Verbosity::Summary, "Left Recursion detected after removal: " + nonTerminal + "\n");
                 }
                 else
                 {
-                    std::cout << "Left Recursion not detected after removal: " << nonTerminal << std::endl;
+                    log(Verbosity::Summary, "Left Recursion not detected after removal: " + nonTerminal + "\n");
                 }
             }
         }
         printGrammar();
         if (!leftFactoringFound) 
         {
-            std::cout << "No left factoring detected.\n";
+            log(Verbosity::Summary, "No left factoring detected.\n");
         }
         if (!leftRecursionFound) 
         {
-            std::cout << "No left recursion detected.\n";
+            log(Verbosity::Summary, "No left recursion detected.\n");
         }
 
         return !(leftFactoringFound || leftRecursionFound);
@@ -1139,40 +1742,36 @@ public:
     It ensures that all FIRST sets are computed before FOLLOW sets, as FOLLOW computation depends on FIRST. The results are printed to files as well as displayed in a table format for easy debugging and verification.
 
     Logic:
-    1. Compute FIRST sets:
-       - Traverse through each non-terminal in the grammar.
-       - Use a recursive helper function `computeFirst` to populate the FIRST set for each non-terminal.
-       - Track visited non-terminals to prevent infinite recursion or redundant computations.
-
-    2. Compute FOLLOW sets:
-       - Reset the visited set to start fresh.
-       - Traverse through each non-terminal in the grammar again.
-       - Use a recursive helper function `computeFollow` to populate the FOLLOW set for each non-terminal.
+    1. Compile the grammar into symbol ids and flat productions (`compileGrammar`).
+
+    2. Compute FIRST sets:
+       - `computeFirst` finds the nullable non-terminals, then solves the FIRST sets of all non-terminals one strongly connected component at a time, in dependency order (`propagate`), and derives the FIRST set of every production suffix.
+       - The result is the same for every order of the non-terminals, including mutually recursive ones.
+
+    3. Compute FOLLOW sets:
+       - `computeFollow` seeds the FOLLOW sets from the production suffixes and solves them the same way.
        - FOLLOW sets are computed after all FIRST sets are finalized.
 
-    3. Output the results:
+    For a grammar with at least `minParallelNonTerminals` non-terminals, independent components, suffixes and FOLLOW seeds are processed on a thread pool (`setThreadCount`). The sets do not depend on the number of threads.
+
+    4. Output the results:
        - Write FIRST and FOLLOW sets to separate files for detailed inspection.
        - Display a formatted table in the console with columns for:
          - Non-terminal name
          - FIRST set as a space-separated string
          - FOLLOW set as a space-separated string
 
-    4. The output allows developers to verify the correctness of the FIRST and FOLLOW sets and identify any issues in the grammar.
+    5. The output allows developers to verify the correctness of the FIRST and FOLLOW sets and identify any issues in the grammar.
 
     </summary>
     */
     void computeFirstAndFollow() 
     {
-        std::unordered_set<std::string> visited;
-        for (std::unordered_map<std::string, std::unordered_set<std::string>>::iterator it = grammar.begin(); it != grammar.end(); ++it)
-        {
-            computeFirst(it->first, visited);
-        }
-
-        visited.clear();
-        for (std::unordered_map<std::string, std::unordered_set<std::string>>::iterator it = grammar.begin(); it != grammar.end(); ++it)
+        compileGrammar();
         {
-            computeFollow(it->first, visited);
+            std::unique_ptr<ThreadPool> workers = startWorkers();
+            computeFirst(workers.get());
+            computeFollow(workers.get());
         }
 
         // Print FIRST and FOLLOW sets separately
@@ -1180,30 +1779,22 @@ public:
         printFollowSetsToFile();
 
         // Display FIRST and FOLLOW sets in table format
-        std::cout << std::left << std::setw(20) << "Non-terminal"
+        if (verbosity < Verbosity::Verbose)
+        {
+            return;
+        }
+        std::ostringstream table;
+        table << std::left << std::setw(20) << "Non-terminal"
             << std::setw(40) << "First"
             << std::setw(40) << "Follow" << std::endl;
 
-        for (std::unordered_map<std::string, std::unordered_set<std::string>>::iterator it = grammar.begin(); it != grammar.end(); ++it)
+        for (int nonTerminal = 0; nonTerminal < nonTerminalCount; ++nonTerminal)
         {
-            const std::string& nonTerminal = it->first;
-
-            std::cout << std::setw(20) << nonTerminal;
-
-            std::string firstSet;
-            for (std::unordered_set<std::string>::iterator firstIt = firstSets[nonTerminal].begin(); firstIt != firstSets[nonTerminal].end(); ++firstIt)
-            {
-                firstSet += *firstIt + " ";
-            }
-            std::cout << std::setw(40) << firstSet;
-
-            std::string followSet;
-            for (std::unordered_set<std::string>::iterator followIt = followSets[nonTerminal].begin(); followIt != followSets[nonTerminal].end(); ++followIt)
-            {
-                followSet += *followIt + " ";
-            }
-            std::cout << followSet << std::endl;
+            table << std::setw(20) << symbolNames[nonTerminal];
+            table << std::setw(40) << firstList(nonTerminal);
+            table << symbolList(followSets, nonTerminal) << std::endl;
         }
+        log(Verbosity::Verbose, table.str());
     }
 
     /* <summary>
@@ -1211,80 +1802,63 @@ public:
 
     Logic:
     1. Iterate through each non-terminal and its associated productions in the grammar.
-    2. For each production:
-       - Compute its FIRST set:
-         - Traverse each token in the production sequentially.
-         - If the token is a terminal, add it to the FIRST set and terminate traversal.
-         - If the token is a non-terminal, merge its FIRST set into the current FIRST set.
-         - If a non-terminal includes EPSILON, continue to the next token; otherwise, stop.
-       - If the production is nullable, include EPSILON in the FIRST set.
-    3. Populate the parse table with entries for terminals in the FIRST set of the production, except for EPSILON.
-    4. For nullable productions (containing EPSILON), add entries for terminals in the FOLLOW set of the non-terminal to the parse table.
+    2. For each production, take its FIRST set and whether it is nullable from the suffix that starts at its first symbol (`computeFirst`); nothing is recomputed per production. The sets are computed first if `computeFirstAndFollow` has not run.
+    3. Populate the parse table with entries for terminals in the FIRST set of the production.
+    4. For nullable productions (deriving EPSILON), add entries for terminals in the FOLLOW set of the non-terminal to the parse table.
     5. Handle error recovery using panic mode by:
        - Adding `sync` entries to the parse table for terminals in the FOLLOW set of the non-terminal if no production exists for those terminals.
     6. The parse table is now complete, and every cell is either populated with a production or a `sync` entry for error recovery.
+       Every row is filled from its own productions only, so for a large grammar the rows are split over a thread pool, like in `computeFirstAndFollow`, with the same result.
+    7. The table is one dense array with a row per non-terminal and a column per terminal of the compiled grammar. A cell holds the 16-bit index of the production, `syncEntry`, or `errorEntry` (no entry), so a parser step is one indexed load. A grammar with more productions than the codes leave room for cannot be tabulated, and the program terminates with an error message.
     </summary> */
     void buildParseTable()
     {
-        for (const auto& entry : grammar)
+        if (symbolNames.empty())
         {
-            const std::string& nonTerminal = entry.first;
-            for (const auto& production : entry.second)
+            compileGrammar();
+        }
+        if (productionLhs.size() >= syncEntry)
+        {
+            std::cerr << "Error: The grammar has too many productions for the parse table." << std::endl;
+            exit(1);
+        }
+        std::unique_ptr<ThreadPool> workers = startWorkers();
+        if (suffixNullable.empty())
+        {
+            computeFirst(workers.get());
+            computeFollow(workers.get());
+        }
+        tableColumns = static_cast<int>(symbolNames.size()) - nonTerminalCount;
+        parseTable.assign(static_cast<size_t>(nonTerminalCount) * tableColumns, errorEntry);
+        // Rows are independent, so they are filled in parallel for a large grammar
+        forRanges(workers.get(), nonTerminalCount, 64, [this](size_t begin, size_t end)
+        {
+            for (int nonTerminal = static_cast<int>(begin); nonTerminal < static_cast<int>(end); ++nonTerminal)
             {
-                std::unordered_set<std::string> firstOfProduction;
-                bool isNullable = true;
-
-                std::istringstream stream(production);
-                std::string token;
-
-                // Compute FIRST set for the production
-                while (isNullable && stream >> token)
+                uint16_t* row = parseTable.data() + static_cast<size_t>(nonTerminal) * tableColumns;
+                const auto setEntry = [row](uint16_t entry) { return [row, entry](size_t column) { row[column] = entry; }; };
+                for (int production = ruleStart[nonTerminal]; production < ruleStart[nonTerminal + 1]; ++production)
                 {
-                    isNullable = false;
+                    const size_t suffix = static_cast<size_t>(productionStart[production]) + production;
 
-                    if (isTerminal(token))
+                    // Populate parse table with FIRST set entries, and with FOLLOW set entries if nullable
+                    suffixFirst.forEach(suffix, setEntry(static_cast<uint16_t>(production)));
+                    if (suffixNullable[suffix])
                     {
-                        firstOfProduction.insert(token);
-                        break;
-                    }
-                    else
-                    {
-                        firstOfProduction.insert(firstSets[token].begin(), firstSets[token].end());
-                        isNullable = firstSets[token].count(EPSILON) > 0;
-                        if (isNullable)
-                            firstOfProduction.erase(EPSILON);
+                        followSets.forEach(nonTerminal, setEntry(static_cast<uint16_t>(production)));
                     }
                 }
 
-                if (isNullable)
-                    firstOfProduction.insert(EPSILON);
-
-                // Populate parse table with FIRST set entries
-                for (const std::string& terminal : firstOfProduction)
+                // Panic mode: Add 'sync' to empty cells in the row for the non-terminal
+                followSets.forEach(nonTerminal, [row](size_t column)
                 {
-                    if (terminal != EPSILON)
-                        parseTable[nonTerminal][terminal] = production;
-                }
-
-                // Populate parse table with FOLLOW set entries if nullable
-                if (firstOfProduction.count(EPSILON) > 0)
-                {
-                    for (const std::string& followSymbol : followSets[nonTerminal])
+                    if (row[column] == errorEntry)
                     {
-                        parseTable[nonTerminal][followSymbol] = production;
+                        row[column] = syncEntry;
                     }
-                }
+                });
             }
-
-            // Panic mode: Add 'sync' to empty cells in the row for the non-terminal
-            for (const std::string& followSymbol : followSets[nonTerminal])
-            {
-                if (parseTable[nonTerminal][followSymbol].empty())
-                {
-                    parseTable[nonTerminal][followSymbol] = "sync";
-                }
-            }
-        }
+        });
     }
 
     // |-------------------------------------------------------------------------------------------------------------|
@@ -1342,8 +1916,8 @@ public:
     This function writes the parse table to a file in a structured and tabular format. It includes the grammar rules for each non-terminal and terminal pair, ensuring proper alignment and readability in the output file.
 
     Logic:
-    1. Extract all unique terminals from the parse table and store them in an unordered set.
-    2. Convert the set into a sorted vector to maintain consistent column ordering.
+    1. Extract all unique terminals from the parse table, sorted by name to maintain consistent column ordering (`parseTableColumns`).
+    2. Only non-terminals with at least one entry get a row, in the order of their ids.
     3. Open a file named `ParseTable.txt` for writing in binary mode to support UTF-8 encoding.
     4. Write a UTF-8 Byte Order Mark (BOM) at the beginning of the file for compatibility with editors.
     5. Define helper functions to:
@@ -1360,19 +1934,8 @@ public:
     </summary> */
     void writeParseTableToFile()
     {
-        // Compute all unique terminals and store them in a set
-        std::unordered_set<std::string> terminalSet;
-        for (const auto& entry : parseTable)
-        {
-            for (const auto& terminalRule : entry.second)
-            {
-                terminalSet.insert(terminalRule.first);
-            }
-        }
-
-        // Convert the set to a sorted vector
-        std::vector<std::string> allTerminals(terminalSet.begin(), terminalSet.end());
-        std::sort(allTerminals.begin(), allTerminals.end());
+        // Compute all unique terminals, sorted by name
+        std::vector<int> allTerminals = parseTableColumns();
 
         // Open the file in text mode with UTF-8 support
         std::ofstream parseTableFile("ParseTable.txt", std::ios::out | std::ios::binary);
@@ -1401,9 +1964,9 @@ public:
 
         // Print the header row
         parseTableFile << "| " << std::setw(14) << std::left << "Non-Terminal" << "|";
-        for (const auto& terminal : allTerminals)
+        for (int terminal : allTerminals)
         {
-            parseTableFile << " " << std::setw(14) << std::left << terminal << "|";
+            parseTableFile << " " << std::setw(14) << std::left << symbolNames[terminal] << "|";
         }
         parseTableFile << "\n";
 
@@ -1411,24 +1974,20 @@ public:
         printSeparator(parseTableFile, allTerminals.size());
 
         // Print each row for the non-terminals
-        for (const auto& entry : parseTable)
+        for (int nonTerminal = 0; nonTerminal < nonTerminalCount; ++nonTerminal)
         {
-            const std::string& nonTerminal = entry.first;
+            if (!hasTableRow(nonTerminal))
+            {
+                continue;
+            }
 
             // Print the non-terminal name
-            parseTableFile << "| " << std::setw(14) << std::left << nonTerminal << "|";
+            parseTableFile << "| " << std::setw(14) << std::left << symbolNames[nonTerminal] << "|";
 
-            // Print the associated terminals
-            for (const auto& terminal : allTerminals)
+            // Print the associated terminals ("-" for missing entries)
+            for (int terminal : allTerminals)
             {
-                if (entry.second.count(terminal))
-                {
-                    parseTableFile << " " << std::setw(14) << std::left << entry.second.at(terminal) << "|";
-                }
-                else
-                {
-                    parseTableFile << " " << std::setw(14) << std::left << "-" << "|";
-                }
+                parseTableFile << " " << std::setw(14) << std::left << entryText(tableEntry(nonTerminal, terminal)) << "|";
             }
             parseTableFile << "\n";
         }
@@ -1444,8 +2003,8 @@ public:
     This function prints the parse table in a tabular format, displaying the grammar rules associated with each non-terminal and terminal pair. It ensures proper formatting and alignment for readability.
 
     Logic:
-    1. Extract all unique terminals from the parse table and store them in an unordered set.
-    2. Convert the set of terminals into a sorted vector for consistent column order.
+    1. Extract all unique terminals from the parse table, sorted by name for consistent column order (`parseTableColumns`).
+    2. Only non-terminals with at least one entry get a row, in the order of their ids.
     3. Define and use helper functions to:
        - Print a row separator line to visually divide the table.
        - Print the header row containing the non-terminal and terminal column names.
@@ -1459,19 +2018,8 @@ public:
     </summary> */
     void printParseTable()
     {
-        // Compute all unique terminals and store them in an ordered array
-        std::unordered_set<std::string> terminalSet;
-        for (const auto& entry : parseTable)
-        {
-            for (const auto& terminalRule : entry.second)
-            {
-                terminalSet.insert(terminalRule.first);
-            }
-        }
-
-        // Convert unordered_set to a sorted vector
-        std::vector<std::string> allTerminals(terminalSet.begin(), terminalSet.end());
-        std::sort(allTerminals.begin(), allTerminals.end());
+        // Compute all unique terminals, sorted by name
+        std::vector<int> allTerminals = parseTableColumns();
 
         // Helper function to print a row separator
         auto printSeparator = [](std::ostream& os, size_t terminalCount) {
@@ -1487,9 +2035,9 @@ public:
 
         auto printHeaders = [&](std::ostream& os) {
             os << "| " << std::setw(14) << std::left << "Non-Terminal" << "|";
-            for (const auto& terminal : allTerminals)
+            for (int terminal : allTerminals)
             {
-                os << " " << std::setw(14) << std::left << terminal << "|";
+                os << " " << std::setw(14) << std::left << symbolNames[terminal] << "|";
             }
             os << "\n";
             };
@@ -1499,22 +2047,18 @@ public:
         printSeparator(std::cout, allTerminals.size());
 
         // Print rows for non-terminals
-        for (const auto& entry : parseTable) // Iterates through non-terminals
+        for (int nonTerminal = 0; nonTerminal < nonTerminalCount; ++nonTerminal) // Iterates through non-terminals
         {
-            const std::string& nonTerminal = entry.first; // Non-terminal key
+            if (!hasTableRow(nonTerminal))
+            {
+                continue;
+            }
 
             auto printRow = [&](std::ostream& os) {
-                os << "| " << std::setw(14) << std::left << nonTerminal << "|"; // Non-terminal column
-                for (const auto& terminal : allTerminals) // Iterates through sorted terminal list
+                os << "| " << std::setw(14) << std::left << symbolNames[nonTerminal] << "|"; // Non-terminal column
+                for (int terminal : allTerminals) // Iterates through sorted terminal list; "-" is the placeholder for missing terminals
                 {
-                    if (entry.second.count(terminal)) // If terminal exists in inner map
-                    {
-                        os << " " << std::setw(14) << std::left << entry.second.at(terminal) << "|";
-                    }
-                    else
-                    {
-                        os << " " << std::setw(14) << std::left << "-" << "|"; // Placeholder for missing terminal
-                    }
+                    os << " " << std::setw(14) << std::left << entryText(tableEntry(nonTerminal, terminal)) << "|";
                 }
                 os << "\n";
                 };
@@ -1526,28 +2070,35 @@ public:
     }
 
     /* <summary>
-    This function recursively prints the parse tree in a structured and indented format to an output stream. Each node of the tree corresponds to a grammar symbol, and its children represent the symbols derived from it.
+    This function prints the parse tree in a structured and indented format to an output stream. Each node of the tree corresponds to a grammar symbol, and its children represent the symbols derived from it.
 
     Logic:
-    1. Indent the current output based on the depth of the recursion to visually represent the hierarchy of the tree.
-    2. Print the current symbol prefixed by a tree marker (`|====>`).
-    3. Check if the current symbol has children in the parse tree.
-    4. If children exist, recursively call `printTree` for each child with an incremented depth to further indent the output.
-    5. If the symbol has no children, terminate the recursion for that branch.
+    1. `nodes` is the node list `parseInput` recorded: node 0 is the start symbol, and every expansion appended one child node per symbol of its production, pointing to the expanded node as its parent. A symbol that is expanded several times gets a node per expansion, so the tree has no cycles.
+    2. Walk the tree depth first with an explicit stack of node indices, starting at the root; the children of a node are pushed in reverse order so they are printed from left to right.
+    3. The depth of a node is the depth of its parent plus one. Indent the output by the depth to visually represent the hierarchy of the tree.
+    4. Print the symbol of each node prefixed by a tree marker (`|====>`).
     </summary> */
-    void printTree(const std::string& symbol, const std::unordered_map<std::string, std::vector<std::string>>& tree, std::ostream& output, int depth = 0)
+    void printTree(const std::vector<ParseNode>& nodes, std::ostream& output) const
     {
-        for (int i = 0; i < depth; ++i)
+        std::vector<int> depth(nodes.size(), 0);
+        std::vector<int> pending{ 0 };
+        while (!pending.empty())
         {
-            output << "    ";
-        }
-        output << "|====> " << symbol << std::endl;
+            const int node = pending.back();
+            pending.pop_back();
+            if (nodes[node].parent >= 0)
+            {
+                depth[node] = depth[nodes[node].parent] + 1;
+            }
+            for (int i = 0; i < depth[node]; ++i)
+            {
+                output << "    ";
+            }
+            output << "|====> " << symbolNames[nodes[node].symbol] << std::endl;
 
-        if (tree.count(symbol))
-        {
-            for (const auto& child : tree.at(symbol))
+            for (int child = nodes[node].firstChild + nodes[node].childCount - 1; child >= nodes[node].firstChild; --child)
             {
-                printTree(child, tree, output, depth + 1);
+                pending.push_back(child);
             }
         }
     }
@@ -1556,9 +2107,9 @@ public:
     This function performs the syntax analysis of a given input string using a parsing table and a starting symbol. It implements a stack-based parsing algorithm to match tokens or expand non-terminals based on grammar rules. The function logs parsing actions, errors, and the generated parse tree.
 
     Logic:
-    1. Initialize a parsing stack with the end marker (`$`) and the start symbol.
-    2. Tokenize the input string and add an end-of-input marker (`$`) to the token list.
-    3. Set up data structures for tracking parsing actions and building the parse tree.
+    1. Look up the start symbol without inserting it. If it is not a non-terminal of the grammar, record "Unknown start symbol", count the input as failed and return `false`, leaving the grammar unchanged. Otherwise initialize a parsing stack with the end marker (`$`) and the start symbol.
+    2. Tokenize the input string and add an end-of-input marker (`$`) to the token list. Every token is looked up once in the symbol table; the stack, the parse table and the FOLLOW sets are then only accessed with symbol ids. A token that is not a symbol of the grammar matches nothing.
+    3. Set up the parse tree as a node list with the start symbol as its root, and a node stack that runs parallel to the parsing stack. Both are only kept when the tree is printed.
     4. Log and display the headers for the stack, input, and actions.
     5. While the parsing stack is not empty and there are tokens left:
        - Extract the top of the stack and the current input token.
@@ -1566,199 +2117,272 @@ public:
        - If the top of the stack matches the current token, record a "Match" action and advance the input token.
        - If the top is a terminal and doesn't match the token, record an error action and advance the input token.
        - If the top is a non-terminal with a rule in the parse table for the current token:
-         - Expand the non-terminal using the rule, log the action, and push the production onto the stack in reverse order.
-         - Update the parse tree to reflect the production.
+         - Expand the non-terminal using the rule, log the action, and copy the symbols of the production onto the stack. `compileGrammar` stored them in reverse order already, so this is one bulk copy onto the stack vector, which keeps its capacity from input to input.
+         - Append a child node per symbol of the production to the parse tree, with the expanded node as their parent, and push the child nodes onto the node stack in the same order as their symbols.
+       - The parse table entry is found with a single indexed load (`tableEntry`).
+       - If the entry is `sync`, the token is in the FOLLOW set of the non-terminal: record an error, pop the non-terminal and keep the token (panic mode synchronization).
        - If no rule exists, enter panic mode for error recovery by skipping tokens until a valid follow set token for the non-terminal is found, then pop the stack.
     6. After processing, check if the parsing stack is empty and all tokens are consumed to determine if parsing was successful.
     7. Log and display the final parse tree structure using the `printTree` function.
     8. Record all errors, parsing steps, and the parse tree in their respective output files.
+    9. Only enabled outputs are written (see `setArtifact` and `setVerbosity`). The stack and input columns of a step are only built when "ParsingProcess.txt", "ParseTree.txt" or the console log needs them, and the tree is printed once and copied to both of its targets.
+    10. Return `true` if the input was parsed successfully.
     </summary> */
-    void parseInput(const std::string& input, const std::string& startSymbol)
+    bool parseInput(const std::string& input, const std::string& startSymbol)
     {
+        if (symbolNames.empty())
+        {
+            compileGrammar();
+        }
+        // Called on its own, outside `parseFromFile`/`parseFromTokens`: log this input directly
+        const bool ownConsole = verbosity == Verbosity::Verbose && !console.is_open();
+        if (ownConsole)
+        {
+            console.attach(*sink);
+        }
+        const bool traceFile = parsingFile.is_open();
+        const bool traceConsole = console.is_open();
+        const bool traceRows = traceFile || traceConsole || parsingTree.is_open();
         bool parseTokenPrinted = false;
-        std::stack<std::string> parsingStack;
-        parsingStack.push("$"); // End marker
-        parsingStack.push(startSymbol); // Start symbol
-
-        std::unordered_map<int, std::string> tokens; // To maintain ordered tokens
+        const bool traceActions = traceFile || traceConsole;
+        // Looked up without inserting: an unknown start symbol must not add a terminal to the compiled grammar
+        const int start = symbolId(startSymbol);
+        if (start < 0 || isTerminal(start))
+        {
+            const std::string error = "Error: Unknown start symbol '" + startSymbol + "'.";
+            if (traceFile)
+            {
+                parsingFile << error << std::endl;
+            }
+            console.text(error).text("\n");
+            errorFile << error << std::endl;
+            parsedInputs++;
+            failedInputs++;
+            if (ownConsole)
+            {
+                console.close();
+            }
+            return false;
+        }
+        std::vector<int>& parsingStack = parseStack;
+        parsingStack.clear();
+        parsingStack.push_back(endSymbol); // End marker
+        parsingStack.push_back(start); // Start symbol
+
+        // The input tokens as symbol ids (-1: not a symbol of the grammar), and their text
+        std::vector<int> tokens;
+        std::vector<std::string> tokenTexts;
         std::istringstream inputStream(input);
 
-        int tokenIndex = 0;
         std::string token;
         while (inputStream >> token)
         {
-            tokens[tokenIndex++] = token;
+            tokens.push_back(symbolId(token));
+            tokenTexts.push_back(token);
         }
-        tokens[tokenIndex] = "$"; // End-of-input marker
+        tokens.push_back(endSymbol); // End-of-input marker
+        tokenTexts.push_back("$");
 
-        tokenIndex = 0;
+        size_t tokenIndex = 0;
         bool success = true;
 
-        std::unordered_map<int, std::string> actions; // Indexed actions for order
-        std::unordered_map<std::string, std::vector<std::string>> parseTree; // Tree structure
-
-        parsingFile << std::left << std::setw(20) << "Stack" << std::setw(20) << "Input" << "Action" << std::endl;
-        std::cout << std::left << std::setw(20) << "Stack" << std::setw(20) << "Input" << "Action" << std::endl;
+        // Tree structure: one node per symbol occurrence, so a recursive rule expanded several times gets a new node every time
+        const bool buildTree = parsingTree.is_open() || traceConsole;
+        std::vector<ParseNode>& parseTree = parseNodes;
+        std::vector<int>& treeStack = nodeStack;
+        parseTree.clear();
+        treeStack.clear();
+        if (buildTree)
+        {
+            parseTree.push_back({ start, -1, 0, 0 });
+            treeStack.push_back(-1); // End marker
+            treeStack.push_back(0); // Start symbol
+        }
 
-        while (!parsingStack.empty() && tokens.count(tokenIndex))
+        if (traceFile)
         {
-            std::string top = parsingStack.top();
-            std::string currentToken = tokens[tokenIndex];
+            parsingFile << std::left << std::setw(20) << "Stack" << std::setw(20) << "Input" << "Action" << std::endl;
+        }
+        console.column("Stack", 20).column("Input", 20).text("Action\n");
 
-            // Display stack and input
-            std::stringstream stackContent, inputContent;
-            std::stack<std::string> tempStack = parsingStack;
-            while (!tempStack.empty())
-            {
-                stackContent << tempStack.top() << " ";
-                tempStack.pop();
-            }
-            for (auto it = tokens.find(tokenIndex); it != tokens.end(); ++it)
+        // Logs one action to the parsing process and the console
+        auto logAction = [&](const std::string& action)
+        {
+            if (traceFile)
             {
-                inputContent << it->second << " ";
+                parsingFile << action << std::endl;
             }
-            parsingFile << std::setw(20) << stackContent.str() << std::setw(20) << inputContent.str();
-            if (!parseTokenPrinted)
+            console.text(action).text("\n");
+        };
+
+        while (!parsingStack.empty() && tokenIndex < tokens.size())
+        {
+            int top = parsingStack.back();
+            int currentToken = tokens[tokenIndex];
+
+            // Display stack and input
+            if (traceRows)
             {
-                parsingTree << "Token: " << std::setw(20) << inputContent.str();
-                parseTokenPrinted = true;
+                std::stringstream stackContent, inputContent;
+                for (auto it = parsingStack.rbegin(); it != parsingStack.rend(); ++it)
+                {
+                    stackContent << symbolNames[*it] << " ";
+                }
+                for (size_t i = tokenIndex; i < tokenTexts.size(); ++i)
+                {
+                    inputContent << tokenTexts[i] << " ";
+                }
+                if (traceFile)
+                {
+                    parsingFile << std::setw(20) << stackContent.str() << std::setw(20) << inputContent.str();
+                }
+                if (!parseTokenPrinted)
+                {
+                    parsingTree << "Token: " << std::setw(20) << inputContent.str();
+                    parseTokenPrinted = true;
+                }
+                console.column(stackContent.str(), 20).column(inputContent.str(), 20);
             }
-            std::cout << std::setw(20) << stackContent.str() << std::setw(20) << inputContent.str();
 
+            uint16_t entry = errorEntry;
             if (top == currentToken) // Match
             {
-                std::string action = "Match: " + currentToken;
-                actions[tokenIndex] = action;
-                parsingFile << action << std::endl;
-                std::cout << action << std::endl;
-                parsingFile << action << std::endl;
-                parsingStack.pop();
+                if (traceActions)
+                {
+                    std::string action = "Match: " + tokenTexts[tokenIndex];
+                    logAction(action);
+                    if (traceFile)
+                    {
+                        parsingFile << action << std::endl;
+                    }
+                }
+                parsingStack.pop_back();
+                if (buildTree)
+                {
+                    treeStack.pop_back();
+                }
                 ++tokenIndex;
             }
-            else if (isTerminal(top) || top == "$") // Error: Terminal mismatch
+            else if (isTerminal(top) || top == endSymbol) // Error: Terminal mismatch
             {
-                std::string action = "Error: Unexpected token '" + currentToken + "'. Expected: '" + top + "'.";
-                actions[tokenIndex] = action;
-                parsingFile << action << std::endl;
+                std::string action = "Error: Unexpected token '" + tokenTexts[tokenIndex] + "'. Expected: '" + symbolNames[top] + "'.";
+                logAction(action);
                 errorFile << action << std::endl;
-                std::cout << action << std::endl;
                 success = false;
                 ++tokenIndex;
             }
-            else if (parseTable[top].count(currentToken)) // Expand using a production
+            else if ((entry = tableEntry(top, currentToken)) < syncEntry) // Expand using a production
             {
-                std::string production = parseTable[top][currentToken];
-                std::string action = "Expand: " + top + " -> " + production;
-                actions[tokenIndex] = action;
-                parsingFile << action << std::endl;
-                std::cout << action << std::endl;
-                parsingStack.pop();
-
-                // Update the tree structure
-                std::vector<std::string> productionSymbols;
-                if (production != EPSILON)
+                const int production = entry;
+                if (traceActions)
                 {
-                    std::istringstream prodStream(production);
-                    std::string symbol;
-                    while (prodStream >> symbol)
-                    {
-                        productionSymbols.push_back(symbol);
-                    }
-                    parseTree[top] = productionSymbols; // Record production in the tree
+                    logAction("Expand: " + symbolNames[top] + " -> " + productionText[production]);
                 }
+                parsingStack.pop_back();
 
-                // Push production onto stack in reverse order
-                std::stack<std::string> tempStack;
-                for (const auto& symbol : productionSymbols)
+                // Push the production, stored in reverse order already, onto the stack in one copy
+                const int* pushed = pushSymbols.data() + pushStart[production];
+                const int* pushedEnd = pushSymbols.data() + pushStart[production + 1];
+                parsingStack.insert(parsingStack.end(), pushed, pushedEnd);
+
+                if (buildTree) // Record the expansion in the tree: new child nodes of the expanded node
                 {
-                    tempStack.push(symbol);
+                    const int node = treeStack.back();
+                    treeStack.pop_back();
+                    const int firstChild = static_cast<int>(parseTree.size());
+                    const int childCount = productionStart[production + 1] - productionStart[production];
+                    parseTree[node].firstChild = firstChild;
+                    parseTree[node].childCount = childCount;
+                    for (int at = productionStart[production]; at < productionStart[production + 1]; ++at)
+                    {
+                        parseTree.push_back({ productionSymbols[at], node, 0, 0 });
+                    }
+                    for (int child = firstChild + childCount - 1; child >= firstChild; --child)
+                    {
+                        treeStack.push_back(child);
+                    }
                 }
-                while (!tempStack.empty())
+            }
+            else if (entry == syncEntry) // Panic Mode: the token follows the non-terminal, so give it up and keep the token
+            {
+                std::string action = "Error: No rule for '" + symbolNames[top] + "' with token '" + tokenTexts[tokenIndex] + "'. Sync: '" + symbolNames[top] + "' popped.";
+                logAction(action);
+                errorFile << action << std::endl;
+                success = false;
+                parsingStack.pop_back();
+                if (buildTree)
                 {
-                    parsingStack.push(tempStack.top());
-                    tempStack.pop();
+                    treeStack.pop_back();
                 }
             }
             else // Panic Mode: Error recovery
             {
-                std::string action = "Error: No rule for '" + top + "' with token '" + currentToken + "'. Entering Panic Mode.";
-                actions[tokenIndex] = action;
-                parsingFile << action << std::endl;               
+                std::string action = "Error: No rule for '" + symbolNames[top] + "' with token '" + tokenTexts[tokenIndex] + "'. Entering Panic Mode.";
+                logAction(action);
                 errorFile << action << std::endl;
-                std::cout << action << std::endl;
                 success = false;
 
-                while (tokens.count(tokenIndex) && followSets[top].count(currentToken) == 0)
+                while (tokenIndex < tokens.size() && !inFollow(top, currentToken))
                 {
                     ++tokenIndex;
-                    if (tokens.count(tokenIndex))
+                    if (tokenIndex < tokens.size())
                     {
                         currentToken = tokens[tokenIndex];
                     }
                 }
-                parsingStack.pop();
+                parsingStack.pop_back();
+                if (buildTree)
+                {
+                    treeStack.pop_back();
+                }
             }
         }
 
         // Check if parsing completed successfully
-        if (success && parsingStack.empty() && !tokens.count(tokenIndex))
+        success = success && parsingStack.empty() && tokenIndex == tokens.size();
+        parsedInputs++;
+        if (success)
         {
-            parsingFile << "Input successfully parsed." << std::endl;
-            std::cout << "Input successfully parsed." << std::endl;
+            logAction("Input successfully parsed.");
         }
         else
         {
-            parsingFile << "Parsing failed." << std::endl;
-            std::cout << "Parsing failed." << std::endl;
+            failedInputs++;
+            logAction("Parsing failed.");
             errorFile << "Parsing failed" << std::endl;
         }
 
         // Output the parse tree
-        parsingTree << "\nParse Tree:\n";
-        std::cout << "\nParse Tree:\n";
-        printTree(startSymbol, parseTree, parsingTree);
-        printTree(startSymbol, parseTree, std::cout);
+        if (buildTree)
+        {
+            std::ostringstream tree;
+            tree << "\nParse Tree:\n";
+            printTree(parseTree, tree);
+            parsingTree << tree.str();
+            console.text(tree.str());
+        }
+        if (ownConsole)
+        {
+            console.close();
+        }
+        return success;
     }
 
     /* <summary>
     This function handles the parsing process of input tokens stored in a file. It reads the tokens line by line, skips the first two lines, and extracts the token values to perform syntax analysis. The results of the parsing process are recorded in output files, including errors, parsing steps, and the parse tree.
 
     Logic:
-    1. Open the "error.txt" file in append mode for logging errors. If the file cannot be opened, print an error message to the console and terminate the program.
-    2. Open the "ParsingProcess.txt" file to log the detailed parsing process. If it fails, log the error in the "error.txt" file and terminate.
-    3. Open the "ParseTree.txt" file to record the parse tree. Handle any opening failure similarly.
-    4. Open the input file specified by `fileName`. If it cannot be opened, log the error and terminate the program.
-    5. Read the file line by line using a loop. Keep track of the line numbers.
-    6. Skip the first two lines as they do not contain token information.
-    7. Extract the first value (token) from each subsequent line. If the line is empty or improperly formatted, log a warning in the "error.txt" file.
-    8. For valid tokens, print and log the parsing process to the console and "ParsingProcess.txt", then call the `parseInput` function to perform parsing using the given token and the starting symbol.
-    9. Close all open files upon completing the parsing process.
+    1. Open "error.txt", "ParsingProcess.txt" and "ParseTree.txt" with `openParsingFiles`, which terminates the program if one of them cannot be opened.
+    2. Open the input file specified by `fileName`. If it cannot be opened, log the error and terminate the program.
+    3. Read the file line by line using a loop. Keep track of the line numbers.
+    4. Skip the first two lines as they do not contain token information.
+    5. Extract the first value (token) from each subsequent line. If the line is empty or improperly formatted, log a warning in the "error.txt" file.
+    6. For valid tokens, print and log the parsing process to the console and "ParsingProcess.txt", then call the `parseInput` function to perform parsing using the given token and the starting symbol.
+    7. Close all open files upon completing the parsing process (`closeParsingFiles`).
     </summary> */
     void parseFromFile(const std::string& fileName, const std::string& startSymbol)
     {
-
-        errorFile.open("error.txt", std::ios::app);
-        if (!errorFile)
-        {
-            std::cerr << "Error: Unable to open error File." << std::endl;
-            exit(1);
-        }
-        errorFile << "\n\n Synthethic Errors from parsing \n\n";
-        parsingFile.open("ParsingProcess.txt");
-        if (!parsingFile)
-        {
-            std::cerr << "Error: Unable to open ParsingProcess File." << std::endl;
-            errorFile << "Error: Unable to open ParsingProcess File." << std::endl;
-
-            exit(1);
-        }
-        parsingTree.open("ParseTree.txt");
-        if (!parsingTree)
-        {
-            std::cerr << "Error: Unable to open ParseTree File." << std::endl;
-            errorFile << "Error: Unable to open ParseTree File." << std::endl;
-            exit(1);
-        }
+        openParsingFiles();
         std::ifstream file(fileName);
         if (!file.is_open())
         {
@@ -1784,11 +2408,17 @@ public:
             std::string firstValue;
             if (lineStream >> firstValue)
             {
-                std::cout << "Parsing line " << lineNumber << ": " << firstValue << std::endl;
-                parsingFile << "Parsing line " << lineNumber << ": " << firstValue << std::endl;
+                console.text("Parsing line ").number(lineNumber).text(": ").text(firstValue).text("\n");
+                if (parsingFile.is_open())
+                {
+                    parsingFile << "Parsing line " << lineNumber << ": " << firstValue << std::endl;
+                }
                 parseInput(firstValue, startSymbol);
-                parsingFile << std::endl;
-                std::cout << std::endl;
+                if (parsingFile.is_open())
+                {
+                    parsingFile << std::endl;
+                }
+                console.text("\n");
             }
             else
             {
@@ -1796,11 +2426,68 @@ public:
                 errorFile << "Warning: Line " << lineNumber << " is empty or improperly formatted." << std::endl;
             }
         }
-        parsingFile.close();
-        parsingTree.close();
-        errorFile.close();
+        closeParsingFiles();
         file.close();
     }
+
+    /* <summary>
+    This function parses the tokens of a lexical analysis run straight from the in-memory token stream (`Lexical::getTokens`), so no token file has to be written and read back between the two phases. It produces the same output as `parseFromFile` on the `tokenLex.txt` of the same run.
+    `Tokens` is `TokenStream` or a mapped `BinaryTokenFile`; both provide `size()`, `kind(i)` and `lexeme(i)`.
+
+    Logic:
+    1. Open "error.txt", "ParsingProcess.txt" and "ParseTree.txt" with `openParsingFiles`.
+    2. Walk the stream in order and skip invalid lexemes, which `tokenLex.txt` does not contain either.
+    3. Number the remaining tokens like the lines of `tokenLex.txt` (the first token is on line 3, after the two header lines) and log "Parsing line <n>: <token>" to the console and "ParsingProcess.txt".
+    4. Call `parseInput` with the token's text and the starting symbol.
+    5. Close all open files upon completing the parsing process (`closeParsingFiles`).
+    </summary> */
+    template <typename Tokens>
+    void parseFromTokens(const Tokens& tokens, const std::string& startSymbol)
+    {
+        openParsingFiles();
+
+        int lineNumber = 2;
+        for (size_t i = 0; i < tokens.size(); ++i)
+        {
+            if (tokens.kind(i) == TokenKind::Invalid)
+            {
+                continue;
+            }
+            lineNumber++;
+
+            std::string value(tokens.lexeme(i));
+            console.text("Parsing line ").number(lineNumber).text(": ").text(value).text("\n");
+            if (parsingFile.is_open())
+            {
+                parsingFile << "Parsing line " << lineNumber << ": " << value << std::endl;
+            }
+            parseInput(value, startSymbol);
+            if (parsingFile.is_open())
+            {
+                parsingFile << std::endl;
+            }
+            console.text("\n");
+        }
+        closeParsingFiles();
+    }
+
+    /* <summary>
+    This function parses the tokens stored in a binary token file (written by `Lexical::setBinaryTokenFile`). The file is mapped and its records are read in place, with the same output as `parseFromTokens`.
+
+    Logic:
+    1. Open the file with `BinaryTokenFile::open`. If it cannot be opened or is not a valid token file, print an error message to the console and terminate the program.
+    2. Hand the mapped file to `parseFromTokens`.
+    </summary> */
+    void parseFromTokenFile(const std::string& fileName, const std::string& startSymbol)
+    {
+        BinaryTokenFile tokenFile;
+        if (!tokenFile.open(fileName))
+        {
+            std::cerr << "Error: Unable to open token file " << fileName << ", or it is truncated or corrupted" << std::endl;
+            exit(1);
+        }
+        parseFromTokens(tokenFile, startSymbol);
+    }
 };
 
 #endif // SYNTHETIC_H
\ No newline at end of file
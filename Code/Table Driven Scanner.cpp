@@ -21,7 +21,7 @@ Logic:
 6. Compute the FIRST and FOLLOW sets using the `computeFirstAndFollow` method.
 7. Build the parse table using the `buildParseTable` method.
 8. Print the parse table to the console using the `printParseTable` method.
-9. Parse the tokenized input from `tokenLex.txt` starting from the `<program>` non-terminal using the `parseFromFile` method.
+9. Parse the tokens produced by the lexical analysis, taken directly from its in-memory token stream (`getTokens`), starting from the `<program>` non-terminal using the `parseFromTokens` method.
 10. Print the parse tree for each processing action.
 11. Return 0 indicating successful execution of the program.
 </summary> */
@@ -52,6 +52,6 @@ int main()
     syntheticAnalzer.buildParseTable();
     syntheticAnalzer.printParseTable();
     syntheticAnalzer.writeParseTableToFile();
-    syntheticAnalzer.parseFromFile("tokenLex.txt", "<program>");
+    syntheticAnalzer.parseFromTokens(lexical.getTokens(), "<program>");
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,348 @@
+﻿#ifndef BINARY_TOKEN_FILE_H
+#define BINARY_TOKEN_FILE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "sourceBuffer.h"
+#include "tokenStream.h"
+
+/* <summary>
+The `BinaryTokenFile` class reads and writes the binary token file, the compact hand-off between the lexer and the parser. The file is mapped and read in place, so the parser does not have to parse text, skip header lines or strip `setw` padding as it does with `tokenLex.txt`.
+
+Logic:
+1. All numbers are little-endian. The file consists of four parts, in this order:
+   - Header (36 bytes): magic "TOKB", version (16 bit), flags (16 bit), token count, lexeme count, position and size of the offset section, position of the pool index, position and size of the string pool (32 bit each).
+   - Records: one fixed-width 12-byte record per token: lexeme id, line, and the lexeme length (upper 24 bits) together with the `TokenKind` (lower 8 bits).
+   - Offsets: the source offset of every token, either as plain 32-bit values or, with `flagDeltaOffsets`, as the difference to the previous token's offset, zigzag-encoded and stored as a varint (1 to 5 bytes).
+   - String pool: `lexemeCount + 1` start positions followed by the lexeme bytes, so lexeme `id` spans `[start[id], start[id + 1])`.
+2. Records are fixed-width, so `kind`, `line`, `length` and `lexeme` of any token are read directly from the mapping. Offsets are decoded once by `open`, because the varint form cannot be indexed.
+3. A lexeme longer than 16 MiB cannot be represented; `write` fails in that case.
+</summary>*/
+class BinaryTokenFile
+{
+private:
+    static constexpr char magic[4] = { 'T', 'O', 'K', 'B' };
+    static constexpr uint16_t version = 1;
+    static constexpr size_t headerSize = 36;
+    static constexpr size_t recordSize = 12;
+
+    SourceBuffer buffer;
+    uint32_t tokenCount = 0;
+    uint32_t lexemeTotal = 0;
+    const char* records = nullptr;
+    const char* poolIndex = nullptr;
+    const char* pool = nullptr;
+    std::vector<uint32_t> offsets;
+
+    static uint32_t load32(const char* data);
+    static void store16(std::vector<char>& out, uint16_t value);
+    static void store32(std::vector<char>& out, uint32_t value);
+    static void patch32(std::vector<char>& out, size_t position, uint32_t value);
+    static void storeVarint(std::vector<char>& out, uint32_t value);
+    bool validContents(uint32_t poolSize) const;
+    bool decodeOffsets(const char* data, size_t size, bool delta);
+
+public:
+    static constexpr uint16_t flagDeltaOffsets = 1;
+
+    static bool write(const std::string& fileName, const TokenStream& tokens, bool deltaOffsets);
+
+    bool open(const std::string& fileName);
+    void close();
+
+    size_t size() const { return tokenCount; }
+    size_t lexemeCount() const { return lexemeTotal; }
+
+    TokenKind kind(size_t index) const { return static_cast<TokenKind>(load32(records + index * recordSize + 8) & 0xFF); }
+    uint32_t length(size_t index) const { return load32(records + index * recordSize + 8) >> 8; }
+    uint32_t line(size_t index) const { return load32(records + index * recordSize + 4); }
+    uint32_t id(size_t index) const { return load32(records + index * recordSize); }
+    uint32_t offset(size_t index) const { return offsets[index]; }
+    std::string_view text(uint32_t lexemeId) const;
+    std::string_view lexeme(size_t index) const { return text(id(index)); }
+};
+
+// |-------------------------------------------------------------------------------------------------------------|
+// |                                             Encoding Helpers                                                |
+// |-------------------------------------------------------------------------------------------------------------|
+
+/* <summary>
+This function reads a little-endian 32-bit value from any (possibly unaligned) position.
+</summary>*/
+uint32_t BinaryTokenFile::load32(const char* data)
+{
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    return static_cast<uint32_t>(bytes[0]) | static_cast<uint32_t>(bytes[1]) << 8
+        | static_cast<uint32_t>(bytes[2]) << 16 | static_cast<uint32_t>(bytes[3]) << 24;
+}
+
+/* <summary>
+These functions append a little-endian 16-bit or 32-bit value to the output, or overwrite a 32-bit value written earlier.
+</summary>*/
+void BinaryTokenFile::store16(std::vector<char>& out, uint16_t value)
+{
+    out.push_back(static_cast<char>(value & 0xFF));
+    out.push_back(static_cast<char>(value >> 8));
+}
+
+void BinaryTokenFile::store32(std::vector<char>& out, uint32_t value)
+{
+    for (int shift = 0; shift < 32; shift += 8)
+        out.push_back(static_cast<char>((value >> shift) & 0xFF));
+}
+
+void BinaryTokenFile::patch32(std::vector<char>& out, size_t position, uint32_t value)
+{
+    for (int i = 0; i < 4; ++i)
+        out[position + i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+}
+
+/* <summary>
+This function appends an unsigned varint: 7 bits per byte, least significant group first, the high bit set on every byte except the last.
+</summary>*/
+void BinaryTokenFile::storeVarint(std::vector<char>& out, uint32_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+// |-------------------------------------------------------------------------------------------------------------|
+// |                                                  Writing                                                    |
+// |-------------------------------------------------------------------------------------------------------------|
+
+/* <summary>
+This function writes a token stream to a binary token file.
+
+Logic:
+1. Build the whole file in memory: the header with placeholder positions, the fixed-width records, the offsets and the string pool.
+2. Offsets are stored as plain 32-bit values, or with `deltaOffsets` as zigzag-encoded varint differences. The cascade sometimes reports the rest of a split token before the part in front of it, so differences can be negative.
+3. Fill in the section positions and sizes in the header, then write the buffer to `fileName` in one call.
+4. Return `false` if a lexeme is too long for a record or the file cannot be written.
+</summary>*/
+bool BinaryTokenFile::write(const std::string& fileName, const TokenStream& tokens, bool deltaOffsets)
+{
+    const size_t count = tokens.size();
+    std::vector<char> out;
+    out.reserve(headerSize + count * (recordSize + 4) + tokens.lexemeCount() * 8);
+
+    // Header, positions are patched below
+    out.insert(out.end(), magic, magic + 4);
+    store16(out, version);
+    store16(out, deltaOffsets ? flagDeltaOffsets : 0);
+    store32(out, static_cast<uint32_t>(count));
+    store32(out, static_cast<uint32_t>(tokens.lexemeCount()));
+    out.resize(headerSize);
+
+    // Records
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (tokens.length(i) > 0xFFFFFF)
+            return false;
+        store32(out, tokens.id(i));
+        store32(out, tokens.line(i));
+        store32(out, tokens.length(i) << 8 | static_cast<uint32_t>(tokens.kind(i)));
+    }
+
+    // Offsets
+    const size_t offsetsPosition = out.size();
+    uint32_t previous = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t current = tokens.offset(i);
+        if (deltaOffsets)
+        {
+            int32_t delta = static_cast<int32_t>(current - previous);
+            storeVarint(out, (static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31));
+            previous = current;
+        }
+        else
+        {
+            store32(out, current);
+        }
+    }
+    const size_t offsetsSize = out.size() - offsetsPosition;
+
+    // String pool
+    const size_t poolIndexPosition = out.size();
+    uint32_t start = 0;
+    for (uint32_t lexemeId = 0; lexemeId < tokens.lexemeCount(); ++lexemeId)
+    {
+        store32(out, start);
+        start += static_cast<uint32_t>(tokens.text(lexemeId).size());
+    }
+    store32(out, start);
+    const size_t poolPosition = out.size();
+    for (uint32_t lexemeId = 0; lexemeId < tokens.lexemeCount(); ++lexemeId)
+    {
+        std::string_view text = tokens.text(lexemeId);
+        out.insert(out.end(), text.begin(), text.end());
+    }
+
+    patch32(out, 16, static_cast<uint32_t>(offsetsPosition));
+    patch32(out, 20, static_cast<uint32_t>(offsetsSize));
+    patch32(out, 24, static_cast<uint32_t>(poolIndexPosition));
+    patch32(out, 28, static_cast<uint32_t>(poolPosition));
+    patch32(out, 32, start);
+
+    std::ofstream file(fileName, std::ios::binary);
+    if (!file.is_open())
+        return false;
+    file.write(out.data(), static_cast<std::streamsize>(out.size()));
+    return static_cast<bool>(file);
+}
+
+// |-------------------------------------------------------------------------------------------------------------|
+// |                                                  Reading                                                    |
+// |-------------------------------------------------------------------------------------------------------------|
+
+/* <summary>
+This function maps a binary token file and checks its structure.
+
+Logic:
+1. Map the file with `SourceBuffer`. Fail if it cannot be opened, is shorter than the header, or does not start with the magic and the supported version.
+2. Read the counts and section positions from the header and check that every section lies inside the file.
+3. Point `records`, `poolIndex` and `pool` into the mapping; records and lexemes are read from there on demand.
+4. Check the contents the accessors trust once, so a truncated or corrupted file cannot make `text` or the parser read outside the mapping: the pool index must be non-decreasing and end within the pool (`validContents`), and every record must have a lexeme id below the lexeme count and a valid `TokenKind`.
+5. Decode the offsets into `offsets`.
+6. On any failure, release the file and return `false`.
+</summary>*/
+bool BinaryTokenFile::open(const std::string& fileName)
+{
+    close();
+    if (!buffer.open(fileName))
+        return false;
+
+    const char* data = buffer.data();
+    const size_t size = buffer.size();
+    if (size < headerSize || std::memcmp(data, magic, 4) != 0 || (load32(data + 4) & 0xFFFF) != version)
+    {
+        close();
+        return false;
+    }
+
+    const uint16_t flags = static_cast<uint16_t>(load32(data + 4) >> 16);
+    tokenCount = load32(data + 8);
+    lexemeTotal = load32(data + 12);
+    const uint64_t offsetsPosition = load32(data + 16);
+    const uint64_t offsetsSize = load32(data + 20);
+    const uint64_t poolIndexPosition = load32(data + 24);
+    const uint64_t poolPosition = load32(data + 28);
+    const uint64_t poolSize = load32(data + 32);
+
+    if (headerSize + uint64_t(tokenCount) * recordSize > offsetsPosition
+        || offsetsPosition + offsetsSize > poolIndexPosition
+        || poolIndexPosition + (uint64_t(lexemeTotal) + 1) * 4 > poolPosition
+        || poolPosition + poolSize > size
+        || load32(data + poolIndexPosition + uint64_t(lexemeTotal) * 4) != poolSize)
+    {
+        close();
+        return false;
+    }
+
+    records = data + headerSize;
+    poolIndex = data + poolIndexPosition;
+    pool = data + poolPosition;
+
+    if (!validContents(static_cast<uint32_t>(poolSize))
+        || !decodeOffsets(data + offsetsPosition, static_cast<size_t>(offsetsSize), (flags & flagDeltaOffsets) != 0))
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+/* <summary>
+This function checks the pool index and the records against the counts of the header: the lexeme starts must never decrease and the last one must not exceed `poolSize`, and every record must refer to an existing lexeme and a known token kind.
+</summary>*/
+bool BinaryTokenFile::validContents(uint32_t poolSize) const
+{
+    uint32_t previous = 0;
+    for (uint32_t lexemeId = 0; lexemeId <= lexemeTotal; ++lexemeId)
+    {
+        uint32_t start = load32(poolIndex + size_t(lexemeId) * 4);
+        if (start < previous || start > poolSize)
+            return false;
+        previous = start;
+    }
+
+    for (uint32_t i = 0; i < tokenCount; ++i)
+    {
+        if (id(i) >= lexemeTotal || static_cast<uint8_t>(kind(i)) > static_cast<uint8_t>(TokenKind::Invalid))
+            return false;
+    }
+    return true;
+}
+
+/* <summary>
+This function decodes the offset section, plain or delta/varint, into one offset per token. It fails if the section ends early.
+</summary>*/
+bool BinaryTokenFile::decodeOffsets(const char* data, size_t size, bool delta)
+{
+    offsets.resize(tokenCount);
+    if (!delta)
+    {
+        if (size < size_t(tokenCount) * 4)
+            return false;
+        for (uint32_t i = 0; i < tokenCount; ++i)
+            offsets[i] = load32(data + size_t(i) * 4);
+        return true;
+    }
+
+    size_t position = 0;
+    uint32_t previous = 0;
+    for (uint32_t i = 0; i < tokenCount; ++i)
+    {
+        uint32_t value = 0;
+        int shift = 0;
+        while (true)
+        {
+            if (position >= size || shift > 28)
+                return false;
+            unsigned char byte = static_cast<unsigned char>(data[position++]);
+            value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+                break;
+            shift += 7;
+        }
+        int32_t difference = static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+        previous += static_cast<uint32_t>(difference);
+        offsets[i] = previous;
+    }
+    return true;
+}
+
+/* <summary>
+This function returns the text of a lexeme id as a view into the mapped string pool. `open` has checked the pool index, so every id below `lexemeCount()` is safe.
+</summary>*/
+std::string_view BinaryTokenFile::text(uint32_t lexemeId) const
+{
+    uint32_t start = load32(poolIndex + size_t(lexemeId) * 4);
+    uint32_t end = load32(poolIndex + size_t(lexemeId) * 4 + 4);
+    return std::string_view(pool + start, end - start);
+}
+
+/* <summary>
+This function releases the mapping and forgets the decoded offsets.
+</summary>*/
+void BinaryTokenFile::close()
+{
+    buffer.close();
+    tokenCount = 0;
+    lexemeTotal = 0;
+    records = nullptr;
+    poolIndex = nullptr;
+    pool = nullptr;
+    offsets.clear();
+}
+
+#endif // BINARY_TOKEN_FILE_H
@@ -0,0 +1,281 @@
+﻿#ifndef DELIMITER_SCAN_H
+#define DELIMITER_SCAN_H
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define DELIMITER_SCAN_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define DELIMITER_SCAN_TARGET(isa)
+#else
+#define DELIMITER_SCAN_TARGET(isa) __attribute__((target(isa)))
+#endif
+#endif
+
+/* <summary>
+The `DelimiterScan` class finds token boundaries in a buffer many bytes at a time. A delimiter is a whitespace character of the "C" locale (`\t`, `\n`, `\v`, `\f`, `\r`, space) or one of `$`, `,`, `;`, `(` and `)`, the same set as `Lexical::isDelimiter`.
+
+Logic:
+1. `findDelimiter` returns the position of the first delimiter at or after `pos` (or `size`), which skips the rest of an identifier or number in bulk. `skipDelimiters` returns the position of the first non-delimiter (or `size`), which skips whitespace runs in bulk.
+2. Three implementations exist:
+   - `Kernel::AVX2` classifies 32 bytes per step, `Kernel::SSE2` 16 bytes per step. Each step computes a delimiter mask with a few compares (one unsigned range check for `\t`..`\r`, one compare each for space, `$`, `,`, `;` and one for `(`/`)` after folding the low bit), turns it into a bit mask and takes the lowest set bit.
+   - `Kernel::Scalar` tests one byte at a time with direct character comparisons (`isDelimiterByte`: the `\t`..`\r` range check and one compare per other delimiter); there is no lookup table. It is used on non-x86 targets and for the tail of the SIMD kernels.
+3. The best kernel the CPU supports is detected once, on first use (`cpuid`, including the OS check for AVX state). `use` can force a kernel, e.g. to compare them in a benchmark; a kernel the CPU lacks falls back to the detected one.
+</summary>*/
+class DelimiterScan
+{
+public:
+    enum class Kernel
+    {
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+    static Kernel detect();
+    static void use(Kernel kernel);
+    static Kernel active() { return current().kernel; }
+
+    static size_t findDelimiter(const char* data, size_t pos, size_t size) { return current().findDelimiter(data, pos, size); }
+    static size_t skipDelimiters(const char* data, size_t pos, size_t size) { return current().skipDelimiters(data, pos, size); }
+
+private:
+    struct Functions
+    {
+        Kernel kernel;
+        size_t (*findDelimiter)(const char*, size_t, size_t);
+        size_t (*skipDelimiters)(const char*, size_t, size_t);
+    };
+
+    static Functions& current();
+    static Functions functionsFor(Kernel kernel);
+    static constexpr bool isDelimiterByte(unsigned char c);
+    static unsigned lowestBit(uint32_t mask);
+
+    static size_t scalarFind(const char* data, size_t pos, size_t size);
+    static size_t scalarSkip(const char* data, size_t pos, size_t size);
+#ifdef DELIMITER_SCAN_X86
+    static size_t sse2Find(const char* data, size_t pos, size_t size);
+    static size_t sse2Skip(const char* data, size_t pos, size_t size);
+    static size_t avx2Find(const char* data, size_t pos, size_t size);
+    static size_t avx2Skip(const char* data, size_t pos, size_t size);
+#endif
+};
+
+// |-------------------------------------------------------------------------------------------------------------|
+// |                                           Kernel Selection                                                  |
+// |-------------------------------------------------------------------------------------------------------------|
+
+/* <summary>
+This function returns the fastest kernel the running CPU supports.
+
+Logic:
+1. On non-x86 targets, return `Kernel::Scalar`.
+2. SSE2 is part of every x86-64 CPU; on 32-bit x86 it is checked with `cpuid` leaf 1.
+3. AVX2 needs `cpuid` leaf 7 (EBX bit 5) and the operating system saving the YMM registers (OSXSAVE and `xgetbv`). GCC and Clang check both with `__builtin_cpu_supports`.
+</summary>*/
+DelimiterScan::Kernel DelimiterScan::detect()
+{
+#ifdef DELIMITER_SCAN_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4] = {};
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+    __cpuid(info, 1);
+    const bool sse2 = (info[3] & (1 << 26)) != 0;
+    const bool osAvx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+    bool avx2 = false;
+    if (maxLeaf >= 7 && osAvx)
+    {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+    }
+#else
+    __builtin_cpu_init();
+    const bool sse2 = __builtin_cpu_supports("sse2");
+    const bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+    if (avx2)
+        return Kernel::AVX2;
+    if (sse2)
+        return Kernel::SSE2;
+#endif
+    return Kernel::Scalar;
+}
+
+/* <summary>
+This function returns the function table of a kernel; kernels not compiled for this target map to the scalar one.
+</summary>*/
+DelimiterScan::Functions DelimiterScan::functionsFor(Kernel kernel)
+{
+#ifdef DELIMITER_SCAN_X86
+    if (kernel == Kernel::AVX2)
+        return { Kernel::AVX2, &DelimiterScan::avx2Find, &DelimiterScan::avx2Skip };
+    if (kernel == Kernel::SSE2)
+        return { Kernel::SSE2, &DelimiterScan::sse2Find, &DelimiterScan::sse2Skip };
+#else
+    (void)kernel;
+#endif
+    return { Kernel::Scalar, &DelimiterScan::scalarFind, &DelimiterScan::scalarSkip };
+}
+
+/* <summary>
+This function holds the active kernel, detected on first use (thread-safe initialization of a function-local static).
+</summary>*/
+DelimiterScan::Functions& DelimiterScan::current()
+{
+    static Functions functions = functionsFor(detect());
+    return functions;
+}
+
+/* <summary>
+This function forces a kernel. A kernel better than the detected one is not available and is replaced by the detected one. It is meant for benchmarks and tests and must not race with running scans.
+</summary>*/
+void DelimiterScan::use(Kernel kernel)
+{
+    Kernel best = detect();
+    current() = functionsFor(static_cast<int>(kernel) <= static_cast<int>(best) ? kernel : best);
+}
+
+// |-------------------------------------------------------------------------------------------------------------|
+// |                                             Scalar Kernel                                                   |
+// |-------------------------------------------------------------------------------------------------------------|
+
+/* <summary>
+This function tells whether a byte is a delimiter. Bytes above 0x7F are not whitespace in the "C" locale and never delimiters.
+</summary>*/
+constexpr bool DelimiterScan::isDelimiterByte(unsigned char c)
+{
+    return (c >= '\t' && c <= '\r') || c == ' ' || c == '$' || c == ',' || c == ';' || c == '(' || c == ')';
+}
+
+/* <summary>
+This function returns the index of the lowest set bit of a non-zero mask.
+</summary>*/
+unsigned DelimiterScan::lowestBit(uint32_t mask)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+size_t DelimiterScan::scalarFind(const char* data, size_t pos, size_t size)
+{
+    while (pos < size && !isDelimiterByte(static_cast<unsigned char>(data[pos])))
+        pos++;
+    return pos;
+}
+
+size_t DelimiterScan::scalarSkip(const char* data, size_t pos, size_t size)
+{
+    while (pos < size && isDelimiterByte(static_cast<unsigned char>(data[pos])))
+        pos++;
+    return pos;
+}
+
+// |-------------------------------------------------------------------------------------------------------------|
+// |                                              SIMD Kernels                                                   |
+// |-------------------------------------------------------------------------------------------------------------|
+
+#ifdef DELIMITER_SCAN_X86
+
+/* <summary>
+These functions compute the delimiter mask of 16 (SSE2) or 32 (AVX2) bytes.
+
+Logic:
+1. `\t`..`\r`: subtract `\t` and keep the bytes whose unsigned value is at most 4 (`min(x, 4) == x`).
+2. Space, `$`, `,` and `;`: one equality compare each.
+3. `(` and `)`: set the low bit (both become `)`) and compare once.
+4. `movemask` turns the byte mask into one bit per byte.
+</summary>*/
+DELIMITER_SCAN_TARGET("sse2")
+static inline uint32_t delimiterMaskSSE2(__m128i bytes)
+{
+    const __m128i control = _mm_sub_epi8(bytes, _mm_set1_epi8('\t'));
+    __m128i mask = _mm_cmpeq_epi8(_mm_min_epu8(control, _mm_set1_epi8(4)), control);
+    mask = _mm_or_si128(mask, _mm_cmpeq_epi8(bytes, _mm_set1_epi8(' ')));
+    mask = _mm_or_si128(mask, _mm_cmpeq_epi8(bytes, _mm_set1_epi8('$')));
+    mask = _mm_or_si128(mask, _mm_cmpeq_epi8(bytes, _mm_set1_epi8(',')));
+    mask = _mm_or_si128(mask, _mm_cmpeq_epi8(bytes, _mm_set1_epi8(';')));
+    mask = _mm_or_si128(mask, _mm_cmpeq_epi8(_mm_or_si128(bytes, _mm_set1_epi8(1)), _mm_set1_epi8(')')));
+    return static_cast<uint32_t>(_mm_movemask_epi8(mask));
+}
+
+DELIMITER_SCAN_TARGET("avx2")
+static inline uint32_t delimiterMaskAVX2(__m256i bytes)
+{
+    const __m256i control = _mm256_sub_epi8(bytes, _mm256_set1_epi8('\t'));
+    __m256i mask = _mm256_cmpeq_epi8(_mm256_min_epu8(control, _mm256_set1_epi8(4)), control);
+    mask = _mm256_or_si256(mask, _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(' ')));
+    mask = _mm256_or_si256(mask, _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('$')));
+    mask = _mm256_or_si256(mask, _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(',')));
+    mask = _mm256_or_si256(mask, _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(';')));
+    mask = _mm256_or_si256(mask, _mm256_cmpeq_epi8(_mm256_or_si256(bytes, _mm256_set1_epi8(1)), _mm256_set1_epi8(')')));
+    return static_cast<uint32_t>(_mm256_movemask_epi8(mask));
+}
+
+/* <summary>
+These functions run the SIMD search: load unaligned blocks while a full block fits, stop at the first block whose mask (or inverted mask, for `skip`) is non-zero, and return the position of its lowest set bit. The remaining tail is handled by the scalar kernel.
+</summary>*/
+DELIMITER_SCAN_TARGET("sse2")
+size_t DelimiterScan::sse2Find(const char* data, size_t pos, size_t size)
+{
+    while (pos + 16 <= size)
+    {
+        uint32_t mask = delimiterMaskSSE2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos)));
+        if (mask != 0)
+            return pos + lowestBit(mask);
+        pos += 16;
+    }
+    return scalarFind(data, pos, size);
+}
+
+DELIMITER_SCAN_TARGET("sse2")
+size_t DelimiterScan::sse2Skip(const char* data, size_t pos, size_t size)
+{
+    while (pos + 16 <= size)
+    {
+        uint32_t mask = ~delimiterMaskSSE2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos))) & 0xFFFFu;
+        if (mask != 0)
+            return pos + lowestBit(mask);
+        pos += 16;
+    }
+    return scalarSkip(data, pos, size);
+}
+
+DELIMITER_SCAN_TARGET("avx2")
+size_t DelimiterScan::avx2Find(const char* data, size_t pos, size_t size)
+{
+    while (pos + 32 <= size)
+    {
+        uint32_t mask = delimiterMaskAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos)));
+        if (mask != 0)
+            return pos + lowestBit(mask);
+        pos += 32;
+    }
+    return sse2Find(data, pos, size);
+}
+
+DELIMITER_SCAN_TARGET("avx2")
+size_t DelimiterScan::avx2Skip(const char* data, size_t pos, size_t size)
+{
+    while (pos + 32 <= size)
+    {
+        uint32_t mask = ~delimiterMaskAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos)));
+        if (mask != 0)
+            return pos + lowestBit(mask);
+        pos += 32;
+    }
+    return sse2Skip(data, pos, size);
+}
+
+#endif // DELIMITER_SCAN_X86
+
+#endif // DELIMITER_SCAN_H
@@ -0,0 +1,76 @@
+#ifndef DIAGNOSTICS_H
+#define DIAGNOSTICS_H
+
+#include <cstdint>
+#include <iostream>
+#include <ostream>
+#include <string_view>
+
+// How much the analyzers write to their diagnostic sink
+enum class Verbosity : uint8_t
+{
+    Quiet,      // nothing
+    Summary,    // one line per phase
+    Verbose     // every token and every parsing step (the default)
+};
+
+// Output files the analyzers can produce; each one can be switched off
+enum class Artifact : uint8_t
+{
+    TokenFile,      // tokenLex.txt
+    SymbolTable,    // symbolTable.txt
+    ErrorFile,      // error.txt (lexical and syntax errors)
+    ParsingProcess, // ParsingProcess.txt
+    ParseTree       // ParseTree.txt
+};
+
+/* <summary>
+The `ArtifactSet` class holds one enable flag per `Artifact`. All artifacts are enabled by default.
+</summary>*/
+class ArtifactSet
+{
+private:
+    unsigned bits = ~0u;
+
+public:
+    void set(Artifact artifact, bool enabled)
+    {
+        unsigned bit = 1u << static_cast<unsigned>(artifact);
+        bits = enabled ? (bits | bit) : (bits & ~bit);
+    }
+    bool enabled(Artifact artifact) const { return (bits >> static_cast<unsigned>(artifact)) & 1u; }
+};
+
+/* <summary>
+The `DiagnosticSink` class is the destination of the console log and trace output of `Lexical` and `Synthetic`. Output arrives in large blocks (see `ReportWriter`), so an implementation can forward, filter, collect or drop it cheaply.
+
+Logic:
+1. `write` receives the next block of text; `flush` is called at the end of each phase.
+2. `StreamSink` forwards to a `std::ostream`. `consoleSink()` is the shared instance for `std::cout`, used by default.
+</summary>*/
+class DiagnosticSink
+{
+public:
+    virtual ~DiagnosticSink() = default;
+    virtual void write(std::string_view text) = 0;
+    virtual void flush() {}
+};
+
+class StreamSink : public DiagnosticSink
+{
+private:
+    std::ostream& stream;
+
+public:
+    explicit StreamSink(std::ostream& output) : stream(output) {}
+    void write(std::string_view text) override { stream.write(text.data(), static_cast<std::streamsize>(text.size())); }
+    void flush() override { stream.flush(); }
+};
+
+DiagnosticSink& consoleSink()
+{
+    static StreamSink sink(std::cout);
+    return sink;
+}
+
+#endif // DIAGNOSTICS_H
@@ -0,0 +1,857 @@
+// Generated by Scanner Generator.cpp from the tables in lexical.h. Do not edit; regenerate after changing a table.
+#ifndef DIRECT_SCANNER_H
+#define DIRECT_SCANNER_H
+
+#include <string_view>
+#include "tokenStream.h"
+
+namespace DirectScanner
+{
+
+constexpr unsigned char identifierClass[256] =
+{
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 3, 3, 3, 3, 3, 3,
+    3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3, 3, 3, 3, 2,
+    3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3, 3, 3, 3, 3,
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+};
+
+// identifierTable: 5 states, 4 columns
+inline int identifierFSM(std::string_view token)
+{
+    const char* p = token.data();
+    const char* const end = p + token.size();
+
+    if (p == end)
+        return -1;
+    switch (identifierClass[static_cast<unsigned char>(*p)])
+    {
+    case 0:
+        ++p;
+        goto S2;
+    case 2:
+        ++p;
+        goto S1;
+    default:
+        return -1;
+    }
+S1:
+    if (p == end)
+        return -1;
+    switch (identifierClass[static_cast<unsigned char>(*p)])
+    {
+    case 0:
+    case 1:
+    case 2:
+        ++p;
+        goto S3;
+    default:
+        return -1;
+    }
+S2:
+    if (p == end)
+        return -1;
+    switch (identifierClass[static_cast<unsigned char>(*p)])
+    {
+    case 0:
+    case 1:
+        ++p;
+        goto S2;
+    case 2:
+        ++p;
+        goto S3;
+    default:
+        return -1;
+    }
+S3:
+    if (p == end)
+        return 3;
+    switch (identifierClass[static_cast<unsigned char>(*p)])
+    {
+    case 0:
+    case 1:
+    case 2:
+        ++p;
+        goto S3;
+    default:
+        return -1;
+    }
+}
+
+constexpr unsigned char numberClass[256] =
+{
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 1, 4, 1, 2, 4, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4, 4, 4, 4, 4, 4,
+    4, 4, 4, 4, 4, 3, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    4, 4, 4, 4, 4, 3, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+};
+
+// numberTable: 8 states, 5 columns
+inline int numberFSM(std::string_view token)
+{
+    const char* p = token.data();
+    const char* const end = p + token.size();
+
+    if (p == end)
+        return -1;
+    switch (numberClass[static_cast<unsigned char>(*p)])
+    {
+    case 0:
+        ++p;
+        goto S2;
+    case 1:
+        ++p;
+        goto S1;
+    case 2:
+        ++p;
+        goto S3;
+    default:
+        return -1;
+    }
+S1:
+    if (p == end)
+        return -1;
+    switch (numberClass[static_cast<unsigned char>(*p)])
+    {
+    case 0:
+        ++p;
+        goto S2;
+    case 2:
+        ++p;
+        goto S3;
+    default:
+        return -1;
+    }
+S2:
+    if (p == end)
+        return 2;
+    switch (numberClass[static_cast<unsigned char>(*p)])
+    {
+    case 0:
+        ++p;
+        goto S2;
+    case 2:
+        ++p;
+        goto S4;
+    case 3:
+        ++p;
+        goto S5;
+    default:
+        return -1;
+    }
+S3:
+    if (p == end)
+        return -1;
+    switch (numberClass[static_cast<unsigned char>(*p)])
+    {
+    case 0:
+        ++p;
+        goto S4;
+    default:
+        return -1;
+    }
+S4:
+    if (p == end)
+        return 4;
+    switch (numberClass[static_cast<unsigned char>(*p)])
+    {
+    case 0:
+        ++p;
+        goto S4;
+    case 3:
+        ++p;
+        goto S5;
+    default:
+        return -1;
+    }
+S5:
+    if (p == end)
+        return -1;
+    switch (numberClass[static_cast<unsigned char>(*p)])
+    {
+    case 0:
+        ++p;
+        goto S7;
+    case 1:
+        ++p;
+        goto S6;
+    default:
+        return -1;
+    }
+S6:
+    if (p == end)
+        return -1;
+    switch (numberClass[static_cast<unsigned char>(*p)])
+    {
+    case 0:
+        ++p;
+        goto S7;
+    default:
+        return -1;
+    }
+S7:
+    if (p == end)
+        return 7;
+    switch (numberClass[static_cast<unsigned char>(*p)])
+    {
+    case 0:
+        ++p;
+        goto S7;
+    default:
+        return -1;
+    }
+}
+
+constexpr unsigned char punctuationClass[256] =
+{
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 2, 6, 3, 6,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 0, 6, 5, 6, 6,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 1, 6, 4, 6, 6,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+};
+
+// punctuationTable: 2 states, 7 columns
+inline int punctuationFSM(std::string_view token)
+{
+    const char* p = token.data();
+    const char* const end = p + token.size();
+
+    if (p == end)
+        return -1;
+    switch (punctuationClass[static_cast<unsigned char>(*p)])
+    {
+    case 0:
+    case 1:
+    case 2:
+    case 3:
+    case 4:
+    case 5:
+        ++p;
+        goto S1;
+    default:
+        return -1;
+    }
+S1:
+    if (p == end)
+        return 1;
+    switch (punctuationClass[static_cast<unsigned char>(*p)])
+    {
+    default:
+        return -1;
+    }
+}
+
+constexpr unsigned char operatorClass[256] =
+{
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 0, 12, 12, 12, 11, 9, 12, 12, 12, 5, 6, 12, 8, 12, 7, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 4, 12, 1, 3, 2, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 10, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+};
+
+// operatorTable: 14 states, 13 columns
+inline int operatorFSM(std::string_view token)
+{
+    const char* p = token.data();
+    const char* const end = p + token.size();
+
+    if (p == end)
+        return -1;
+    switch (operatorClass[static_cast<unsigned char>(*p)])
+    {
+    case 0:
+        ++p;
+        goto S1;
+    case 1:
+        ++p;
+        goto S2;
+    case 2:
+        ++p;
+        goto S3;
+    case 3:
+        ++p;
+        goto S4;
+    case 4:
+        ++p;
+        goto S5;
+    case 5:
+        ++p;
+        goto S6;
+    case 6:
+        ++p;
+        goto S7;
+    case 7:
+        ++p;
+        goto S8;
+    case 8:
+        ++p;
+        goto S9;
+    case 9:
+        ++p;
+        goto S10;
+    case 10:
+        ++p;
+        goto S11;
+    case 11:
+        ++p;
+        goto S12;
+    default:
+        return -1;
+    }
+S1:
+    if (p == end)
+        return -1;
+    switch (operatorClass[static_cast<unsigned char>(*p)])
+    {
+    case 3:
+        ++p;
+        goto S13;
+    default:
+        return -1;
+    }
+S2:
+    if (p == end)
+        return -1;
+    switch (operatorClass[static_cast<unsigned char>(*p)])
+    {
+    case 1:
+    case 2:
+        ++p;
+        goto S13;
+    default:
+        return -1;
+    }
+S3:
+    if (p == end)
+        return -1;
+    switch (operatorClass[static_cast<unsigned char>(*p)])
+    {
+    case 2:
+        ++p;
+        goto S13;
+    default:
+        return -1;
+    }
+S4:
+    if (p == end)
+        return -1;
+    switch (operatorClass[static_cast<unsigned char>(*p)])
+    {
+    case 1:
+    case 2:
+    case 3:
+    case 6:
+        ++p;
+        goto S13;
+    case 4:
+        ++p;
+        goto S4;
+    default:
+        return -1;
+    }
+S5:
+    if (p == end)
+        return 5;
+    switch (operatorClass[static_cast<unsigned char>(*p)])
+    {
+    case 3:
+    case 4:
+        ++p;
+        goto S13;
+    default:
+        return -1;
+    }
+S6:
+    if (p == end)
+        return 6;
+    switch (operatorClass[static_cast<unsigned char>(*p)])
+    {
+    default:
+        return -1;
+    }
+S7:
+    if (p == end)
+        return 7;
+    switch (operatorClass[static_cast<unsigned char>(*p)])
+    {
+    case 6:
+        ++p;
+        goto S13;
+    default:
+        return -1;
+    }
+S8:
+    if (p == end)
+        return 8;
+    switch (operatorClass[static_cast<unsigned char>(*p)])
+    {
+    default:
+        return -1;
+    }
+S9:
+    if (p == end)
+        return 9;
+    switch (operatorClass[static_cast<unsigned char>(*p)])
+    {
+    case 8:
+        ++p;
+        goto S13;
+    default:
+        return -1;
+    }
+S10:
+    if (p == end)
+        return -1;
+    switch (operatorClass[static_cast<unsigned char>(*p)])
+    {
+    case 9:
+        ++p;
+        goto S13;
+    default:
+        return -1;
+    }
+S11:
+    if (p == end)
+        return -1;
+    switch (operatorClass[static_cast<unsigned char>(*p)])
+    {
+    case 10:
+        ++p;
+        goto S13;
+    default:
+        return -1;
+    }
+S12:
+    if (p == end)
+        return 12;
+    switch (operatorClass[static_cast<unsigned char>(*p)])
+    {
+    case 11:
+        ++p;
+        goto S13;
+    default:
+        return -1;
+    }
+S13:
+    if (p == end)
+        return 13;
+    switch (operatorClass[static_cast<unsigned char>(*p)])
+    {
+    default:
+        return -1;
+    }
+}
+
+constexpr unsigned char mergedClass[256] =
+{
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 1, 0, 0, 0, 2, 3, 0, 0, 0, 4, 5, 0, 6, 7, 8, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 10, 0, 11, 12, 13, 0,
+    0, 14, 14, 14, 14, 15, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 16, 0, 17, 0, 18,
+    0, 14, 14, 14, 14, 15, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 19, 20, 21, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+// Merged DFA: 24 states, 22 classes. Reads from `p` as far as the DFA goes and returns where it stopped;
+// `acceptEnd`/`acceptKind` and `keywordEnd` are updated like in `Lexical::scanMerged`.
+inline const char* merged(const char* p, const char* const end, const char*& acceptEnd, TokenKind& acceptKind, const char*& keywordEnd)
+{
+    if (p == end)
+        return p;
+    switch (mergedClass[static_cast<unsigned char>(*p)])
+    {
+    case 1:
+        ++p;
+        goto M1;
+    case 2:
+        ++p;
+        goto M2;
+    case 3:
+        ++p;
+        goto M3;
+    case 4:
+        ++p;
+        goto M4;
+    case 5:
+        ++p;
+        goto M5;
+    case 6:
+        ++p;
+        goto M6;
+    case 7:
+        ++p;
+        goto M7;
+    case 8:
+        ++p;
+        goto M8;
+    case 9:
+        ++p;
+        goto M9;
+    case 10:
+        ++p;
+        goto M10;
+    case 11:
+        ++p;
+        goto M11;
+    case 12:
+        ++p;
+        goto M12;
+    case 13:
+        ++p;
+        goto M13;
+    case 14:
+    case 15:
+        ++p;
+        goto M14;
+    case 16:
+    case 17:
+    case 19:
+    case 21:
+        ++p;
+        goto M15;
+    case 18:
+        ++p;
+        goto M16;
+    case 20:
+        ++p;
+        goto M17;
+    default:
+        return p;
+    }
+M1:
+    if (p == end)
+        return p;
+    switch (mergedClass[static_cast<unsigned char>(*p)])
+    {
+    case 12:
+        ++p;
+        goto M18;
+    default:
+        return p;
+    }
+M2:
+    acceptEnd = p;
+    acceptKind = TokenKind::Operator;
+    if (p == end)
+        return p;
+    switch (mergedClass[static_cast<unsigned char>(*p)])
+    {
+    case 2:
+        ++p;
+        goto M18;
+    default:
+        return p;
+    }
+M3:
+    if (p == end)
+        return p;
+    switch (mergedClass[static_cast<unsigned char>(*p)])
+    {
+    case 3:
+        ++p;
+        goto M18;
+    default:
+        return p;
+    }
+M4:
+    acceptEnd = p;
+    acceptKind = TokenKind::Operator;
+    if (p == end)
+        return p;
+    switch (mergedClass[static_cast<unsigned char>(*p)])
+    {
+    default:
+        return p;
+    }
+M5:
+    acceptEnd = p;
+    acceptKind = TokenKind::Operator;
+    if (p == end)
+        return p;
+    switch (mergedClass[static_cast<unsigned char>(*p)])
+    {
+    case 5:
+        ++p;
+        goto M18;
+    case 7:
+        ++p;
+        goto M7;
+    case 9:
+        ++p;
+        goto M9;
+    default:
+        return p;
+    }
+M6:
+    acceptEnd = p;
+    acceptKind = TokenKind::Operator;
+    if (p == end)
+        return p;
+    switch (mergedClass[static_cast<unsigned char>(*p)])
+    {
+    case 6:
+        ++p;
+        goto M18;
+    case 7:
+        ++p;
+        goto M7;
+    case 9:
+        ++p;
+        goto M9;
+    default:
+        return p;
+    }
+M7:
+    if (p == end)
+        return p;
+    switch (mergedClass[static_cast<unsigned char>(*p)])
+    {
+    case 9:
+        ++p;
+        goto M19;
+    default:
+        return p;
+    }
+M8:
+    acceptEnd = p;
+    acceptKind = TokenKind::Operator;
+    if (p == end)
+        return p;
+    switch (mergedClass[static_cast<unsigned char>(*p)])
+    {
+    default:
+        return p;
+    }
+M9:
+    acceptEnd = p;
+    acceptKind = TokenKind::Number;
+    if (p == end)
+        return p;
+    switch (mergedClass[static_cast<unsigned char>(*p)])
+    {
+    case 7:
+        ++p;
+        goto M19;
+    case 9:
+        ++p;
+        goto M9;
+    case 15:
+        ++p;
+        goto M20;
+    default:
+        return p;
+    }
+M10:
+    acceptEnd = p;
+    acceptKind = TokenKind::Operator;
+    if (p == end)
+        return p;
+    switch (mergedClass[static_cast<unsigned char>(*p)])
+    {
+    case 10:
+    case 12:
+        ++p;
+        goto M18;
+    default:
+        return p;
+    }
+M11:
+    acceptEnd = p;
+    acceptKind = TokenKind::Punctuation;
+    if (p == end)
+        return p;
+    switch (mergedClass[static_cast<unsigned char>(*p)])
+    {
+    case 11:
+    case 13:
+        ++p;
+        goto M18;
+    default:
+        return p;
+    }
+M12:
+    if (p == end)
+        return p;
+    switch (mergedClass[static_cast<unsigned char>(*p)])
+    {
+    case 5:
+    case 11:
+    case 12:
+    case 13:
+        ++p;
+        goto M18;
+    case 10:
+        ++p;
+        goto M12;
+    default:
+        return p;
+    }
+M13:
+    acceptEnd = p;
+    acceptKind = TokenKind::Punctuation;
+    if (p == end)
+        return p;
+    switch (mergedClass[static_cast<unsigned char>(*p)])
+    {
+    case 13:
+        ++p;
+        goto M18;
+    default:
+        return p;
+    }
+M14:
+    keywordEnd = p;
+    if (p == end)
+        return p;
+    switch (mergedClass[static_cast<unsigned char>(*p)])
+    {
+    case 9:
+    case 14:
+    case 15:
+        ++p;
+        goto M14;
+    case 18:
+        ++p;
+        goto M21;
+    default:
+        return p;
+    }
+M15:
+    acceptEnd = p;
+    acceptKind = TokenKind::Punctuation;
+    if (p == end)
+        return p;
+    switch (mergedClass[static_cast<unsigned char>(*p)])
+    {
+    default:
+        return p;
+    }
+M16:
+    if (p == end)
+        return p;
+    switch (mergedClass[static_cast<unsigned char>(*p)])
+    {
+    case 9:
+    case 14:
+    case 15:
+    case 18:
+        ++p;
+        goto M21;
+    default:
+        return p;
+    }
+M17:
+    if (p == end)
+        return p;
+    switch (mergedClass[static_cast<unsigned char>(*p)])
+    {
+    case 20:
+        ++p;
+        goto M18;
+    default:
+        return p;
+    }
+M18:
+    acceptEnd = p;
+    acceptKind = TokenKind::Operator;
+    if (p == end)
+        return p;
+    switch (mergedClass[static_cast<unsigned char>(*p)])
+    {
+    default:
+        return p;
+    }
+M19:
+    acceptEnd = p;
+    acceptKind = TokenKind::Number;
+    if (p == end)
+        return p;
+    switch (mergedClass[static_cast<unsigned char>(*p)])
+    {
+    case 9:
+        ++p;
+        goto M19;
+    case 15:
+        ++p;
+        goto M20;
+    default:
+        return p;
+    }
+M20:
+    if (p == end)
+        return p;
+    switch (mergedClass[static_cast<unsigned char>(*p)])
+    {
+    case 5:
+    case 6:
+        ++p;
+        goto M22;
+    case 9:
+        ++p;
+        goto M23;
+    default:
+        return p;
+    }
+M21:
+    acceptEnd = p;
+    acceptKind = TokenKind::Identifier;
+    if (p == end)
+        return p;
+    switch (mergedClass[static_cast<unsigned char>(*p)])
+    {
+    case 9:
+    case 14:
+    case 15:
+    case 18:
+        ++p;
+        goto M21;
+    default:
+        return p;
+    }
+M22:
+    if (p == end)
+        return p;
+    switch (mergedClass[static_cast<unsigned char>(*p)])
+    {
+    case 9:
+        ++p;
+        goto M23;
+    default:
+        return p;
+    }
+M23:
+    acceptEnd = p;
+    acceptKind = TokenKind::Number;
+    if (p == end)
+        return p;
+    switch (mergedClass[static_cast<unsigned char>(*p)])
+    {
+    case 9:
+        ++p;
+        goto M23;
+    default:
+        return p;
+    }
+}
+
+} // namespace DirectScanner
+
+#endif // DIRECT_SCANNER_H
@@ -0,0 +1,286 @@
+#ifndef INTERN_TABLE_H
+#define INTERN_TABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/* <summary>
+The `InternTable` class assigns every distinct lexeme a dense 32-bit id and stores its text once.
+
+Logic:
+1. The hash is 32-bit FNV-1a, which is computed one byte at a time: `hashSeed`, then `hashStep` for every byte. A scanner that already walks the bytes of a lexeme accumulates the hash on the way and passes it to `intern`, so the text is not read a second time; `hash` computes it for callers that did not.
+2. The slots are an open-addressing table of (hash, id + 1) pairs with linear probing, kept at most half full. A probe compares the stored hash first and the text only when the hashes are equal, so a lookup usually touches one slot and one string.
+3. The texts are appended to one byte arena; `starts[id]` and `starts[id + 1]` delimit the text of `id`. Ids are handed out in order of first appearance, starting at 0. A repeated lexeme costs nothing beyond the lookup.
+4. The views `text` returns stay valid until the next `intern` of a new text (the arena may grow) or `clear`.
+</summary>*/
+class InternTable
+{
+private:
+    struct Slot
+    {
+        uint32_t hash = 0;
+        uint32_t idPlusOne = 0; // 0: empty
+    };
+
+    std::vector<Slot> slots;
+    std::vector<char> bytes;
+    std::vector<uint32_t> starts{ 0 };
+    std::vector<uint32_t> hashes;
+
+    // Spreads the FNV-1a bits over the low bits that select the slot
+    static uint32_t slotOf(uint32_t hash, size_t mask) { return (hash ^ (hash >> 15)) * 0x2C1B3C6Du & static_cast<uint32_t>(mask); }
+
+    void grow();
+
+    friend class ConcurrentInternTable;
+
+public:
+    static constexpr uint32_t hashSeed = 2166136261u;
+    static constexpr uint32_t hashStep(uint32_t hash, char c) { return (hash ^ static_cast<unsigned char>(c)) * 16777619u; }
+    static constexpr uint32_t hash(std::string_view text)
+    {
+        uint32_t h = hashSeed;
+        for (char c : text)
+            h = hashStep(h, c);
+        return h;
+    }
+
+    void clear();
+    uint32_t intern(std::string_view text) { return intern(text, hash(text)); }
+    uint32_t intern(std::string_view text, uint32_t textHash);
+
+    size_t size() const { return hashes.size(); }
+    std::string_view text(uint32_t id) const { return std::string_view(bytes.data() + starts[id], starts[id + 1] - starts[id]); }
+    uint32_t hashOf(uint32_t id) const { return hashes[id]; }
+};
+
+/* <summary>
+This function removes all texts; ids start at 0 again.
+</summary>*/
+void InternTable::clear()
+{
+    slots.clear();
+    bytes.clear();
+    starts.assign(1, 0);
+    hashes.clear();
+}
+
+/* <summary>
+This function doubles the slot table (16 slots at first) and re-inserts the ids from their stored hashes, without touching the texts.
+</summary>*/
+void InternTable::grow()
+{
+    std::vector<Slot> old(slots.empty() ? 16 : slots.size() * 2);
+    old.swap(slots);
+    const size_t mask = slots.size() - 1;
+    for (const Slot& slot : old)
+    {
+        if (slot.idPlusOne == 0)
+            continue;
+        size_t i = slotOf(slot.hash, mask);
+        while (slots[i].idPlusOne != 0)
+            i = (i + 1) & mask;
+        slots[i] = slot;
+    }
+}
+
+/* <summary>
+This function returns the id of `text`, whose FNV-1a hash is `textHash`, adding the text when it is seen for the first time.
+
+Logic:
+1. Probe from the slot of the hash. A slot with the same hash is a hit when its text is equal; an empty slot ends the search.
+2. For a new text, append it to the arena, record its hash and claim the empty slot. The table grows before it would become more than half full.
+</summary>*/
+uint32_t InternTable::intern(std::string_view text, uint32_t textHash)
+{
+    if ((hashes.size() + 1) * 2 > slots.size())
+        grow();
+
+    const size_t mask = slots.size() - 1;
+    size_t i = slotOf(textHash, mask);
+    while (slots[i].idPlusOne != 0)
+    {
+        const Slot& slot = slots[i];
+        if (slot.hash == textHash && this->text(slot.idPlusOne - 1) == text)
+            return slot.idPlusOne - 1;
+        i = (i + 1) & mask;
+    }
+
+    uint32_t id = static_cast<uint32_t>(hashes.size());
+    bytes.insert(bytes.end(), text.begin(), text.end());
+    starts.push_back(static_cast<uint32_t>(bytes.size()));
+    hashes.push_back(textHash);
+    slots[i] = { textHash, id + 1 };
+    return id;
+}
+
+/* <summary>
+The `ConcurrentInternTable` class is an `InternTable` that many threads use at once, e.g. the `Lexical` instances that lex several files or the chunks of one file in parallel, so every common identifier and keyword is stored once for all of them instead of once per thread.
+
+Logic:
+1. The hash and the id contract are the ones of `InternTable`: FNV-1a, dense 32-bit ids in order of first (successful) insertion, `text(id)` and `hashOf(id)`.
+2. The capacity (the number of distinct texts) is fixed by the constructor; the slot table has at least twice as many slots, so it never needs to grow and a probe always reaches an empty slot. Each slot is one 64-bit atomic word: the hash in the high half and the state in the low half (0: empty, 1: claimed, id + 2: published).
+3. A lookup probes with plain acquire loads and takes no lock. A slot whose hash differs is skipped without looking at the text; a slot with the same hash that is still being filled in is waited for, which only happens when two threads insert the same new text at the same time.
+4. A new text claims its empty slot with one compare-and-swap. The winner takes the next id, copies the text into the arena, records the entry and then publishes the id with a release store, so a thread that sees the id also sees the text. A loser re-reads the slot and continues probing, so each text gets exactly one id.
+5. The arena is append-only: a list of blocks, each filled by an atomic bump of its cursor. Only the thread that finds the current block exhausted takes a mutex to install the next one; texts never move, so the views `text` returns stay valid as long as the table.
+6. When the capacity is exhausted, `intern` returns `full` for a new text (known texts are still found).
+</summary>*/
+class ConcurrentInternTable
+{
+private:
+    struct Entry
+    {
+        const char* text = nullptr;
+        uint32_t length = 0;
+        uint32_t hash = 0;
+    };
+
+    struct Block
+    {
+        std::unique_ptr<char[]> data;
+        size_t size;
+        std::atomic<size_t> used{ 0 };
+        explicit Block(size_t blockSize) : data(new char[blockSize]), size(blockSize) {}
+    };
+
+    static constexpr uint64_t emptyState = 0;
+    static constexpr uint64_t claimedState = 1;
+    static constexpr size_t blockSize = size_t(1) << 16;
+
+    size_t capacity;
+    size_t mask;
+    std::unique_ptr<std::atomic<uint64_t>[]> slots;
+    std::unique_ptr<Entry[]> entries;
+    std::atomic<uint32_t> nextId{ 0 };
+    std::atomic<size_t> reserved{ 0 };
+
+    std::atomic<Block*> current{ nullptr };
+    std::vector<std::unique_ptr<Block>> blocks;
+    std::mutex blockMutex;
+
+    char* allocate(size_t count);
+
+public:
+    static constexpr uint32_t full = UINT32_MAX;
+
+    explicit ConcurrentInternTable(size_t maxTexts = size_t(1) << 20);
+    ConcurrentInternTable(const ConcurrentInternTable&) = delete;
+    ConcurrentInternTable& operator=(const ConcurrentInternTable&) = delete;
+
+    uint32_t intern(std::string_view text) { return intern(text, InternTable::hash(text)); }
+    uint32_t intern(std::string_view text, uint32_t textHash);
+
+    // The number of ids handed out; an id that is still being published counts already
+    size_t size() const { return nextId.load(std::memory_order_acquire); }
+    size_t maxSize() const { return capacity; }
+    std::string_view text(uint32_t id) const { return std::string_view(entries[id].text, entries[id].length); }
+    uint32_t hashOf(uint32_t id) const { return entries[id].hash; }
+};
+
+/* <summary>
+This constructor allocates room for `maxTexts` distinct texts: the entries, a slot table of at least twice that many slots (a power of two), and the first arena block.
+</summary>*/
+ConcurrentInternTable::ConcurrentInternTable(size_t maxTexts) : capacity(maxTexts < full ? maxTexts : full - 1)
+{
+    size_t slotCount = 16;
+    while (slotCount < capacity * 2)
+        slotCount *= 2;
+    mask = slotCount - 1;
+    slots.reset(new std::atomic<uint64_t>[slotCount]);
+    for (size_t i = 0; i < slotCount; ++i)
+        slots[i].store(emptyState, std::memory_order_relaxed);
+    entries.reset(new Entry[capacity]);
+    blocks.push_back(std::make_unique<Block>(blockSize));
+    current.store(blocks.back().get(), std::memory_order_release);
+}
+
+/* <summary>
+This function returns room for `count` bytes in the arena.
+
+Logic:
+1. Bump the cursor of the current block; if the bytes fit, they belong to this thread alone.
+2. Otherwise lock, and if no other thread has replaced the block in the meantime, install a new one (large enough for `count`). Retry with the current block.
+</summary>*/
+char* ConcurrentInternTable::allocate(size_t count)
+{
+    while (true)
+    {
+        Block* block = current.load(std::memory_order_acquire);
+        size_t at = block->used.fetch_add(count, std::memory_order_relaxed);
+        if (at + count <= block->size)
+            return block->data.get() + at;
+
+        std::lock_guard<std::mutex> lock(blockMutex);
+        if (current.load(std::memory_order_relaxed) == block)
+        {
+            blocks.push_back(std::make_unique<Block>(count > blockSize ? count : blockSize));
+            current.store(blocks.back().get(), std::memory_order_release);
+        }
+    }
+}
+
+/* <summary>
+This function returns the id of `text`, whose FNV-1a hash is `textHash`, adding the text when no thread has added it yet. It is safe to call from any number of threads at once.
+
+Logic:
+1. Probe from the slot of the hash. Skip slots with another hash. Wait for a claimed slot with the same hash to be published, then compare the text; an equal text is a hit.
+2. At an empty slot, reserve room for one more text (or return `full`) and try to claim the slot. If another thread claimed it first, look at the slot again: it may hold the same text.
+3. The winner assigns the id, copies the text, fills in the entry and publishes the slot.
+</summary>*/
+uint32_t ConcurrentInternTable::intern(std::string_view text, uint32_t textHash)
+{
+    const uint64_t tag = uint64_t(textHash) << 32;
+    bool haveRoom = false;
+    size_t i = InternTable::slotOf(textHash, mask);
+    while (true)
+    {
+        uint64_t slot = slots[i].load(std::memory_order_acquire);
+        if (slot == emptyState)
+        {
+            if (!haveRoom)
+            {
+                if (reserved.fetch_add(1, std::memory_order_relaxed) >= capacity)
+                {
+                    reserved.fetch_sub(1, std::memory_order_relaxed);
+                    return full;
+                }
+                haveRoom = true;
+            }
+            if (!slots[i].compare_exchange_strong(slot, tag | claimedState, std::memory_order_acq_rel, std::memory_order_acquire))
+                continue;
+
+            uint32_t id = nextId.fetch_add(1, std::memory_order_relaxed);
+            char* copy = allocate(text.size());
+            std::memcpy(copy, text.data(), text.size());
+            entries[id] = { copy, static_cast<uint32_t>(text.size()), textHash };
+            slots[i].store(tag | (uint64_t(id) + 2), std::memory_order_release);
+            return id;
+        }
+
+        if ((slot & ~uint64_t(UINT32_MAX)) == tag)
+        {
+            while ((slot & UINT32_MAX) == claimedState)
+            {
+                std::this_thread::yield();
+                slot = slots[i].load(std::memory_order_acquire);
+            }
+            uint32_t id = static_cast<uint32_t>(slot & UINT32_MAX) - 2;
+            if (this->text(id) == text)
+            {
+                if (haveRoom)
+                    reserved.fetch_sub(1, std::memory_order_relaxed);
+                return id;
+            }
+        }
+        i = (i + 1) & mask;
+    }
+}
+
+#endif // INTERN_TABLE_H
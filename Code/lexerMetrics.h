@@ -0,0 +1,317 @@
+#ifndef LEXER_METRICS_H
+#define LEXER_METRICS_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include "tokenStream.h"
+
+// Phases of a lexer run, as timed by `LexerMetrics`
+enum class LexPhase : uint8_t
+{
+    Read,     // opening and mapping the input
+    Scan,     // finding the tokens (delimiter scans, line reading in the stream mode)
+    Classify, // running the FSMs / DFA on the tokens
+    Report,   // formatting the console log and the report files per token
+    Write     // summaries, flushing and closing the files, the binary token file
+};
+
+/* <summary>
+The `LexerMetrics` class collects the statistics of one lexer run: tokens and lexeme bytes per token class, time per phase, a latency histogram of single tokens, and the input and token rates. `toJson` and `writeJson` export them as one JSON object, so a production log can carry them without a profiler.
+
+Logic:
+1. The per-class counts and bytes are taken from the token stream at the end of the run (`finish`), so counting costs nothing while scanning.
+2. `Read`, `Scan` and `Write` are timed once per run. Timing every token would cost more than classifying it, so one token in `sampleEvery` is timed as a whole (classification plus its report lines) and its report lines on their own. The sampled times give the latency histogram and, scaled by the number of tokens, the estimated `Classify` and `Report` times, which `finish` takes out of the measured `Scan` time.
+   A clock read costs tens of nanoseconds, a sizable part of one token, so `begin` measures it and `recordToken` takes the reads inside a sampled span out of it.
+3. The histogram has power-of-two buckets: bucket `k` counts sampled tokens that took `[2^k, 2^(k+1))` nanoseconds (bucket 0 also counts 0 ns). Percentiles are reported as the upper bound of the bucket they fall into.
+4. `Stopwatch` adds the time until `stop` (or the end of its scope) to a counter, or does nothing, not even read the clock, when it has no counter. `phaseCounter` gives the counter of a phase.
+</summary>*/
+class LexerMetrics
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr size_t phaseCount = 5;
+    static constexpr size_t kindCount = 6;
+    static constexpr size_t bucketCount = 32;
+
+    class Stopwatch
+    {
+    private:
+        uint64_t* target;
+        Clock::time_point start;
+
+    public:
+        explicit Stopwatch(uint64_t* nanos) : target(nanos)
+        {
+            if (target)
+                start = Clock::now();
+        }
+        ~Stopwatch() { stop(); }
+        void stop()
+        {
+            if (target)
+                *target += LexerMetrics::nanosSince(start);
+            target = nullptr;
+        }
+        Stopwatch(const Stopwatch&) = delete;
+        Stopwatch& operator=(const Stopwatch&) = delete;
+    };
+
+private:
+    unsigned sampleEvery = 64;
+    unsigned countdown = 1;
+
+    std::array<uint64_t, kindCount> kindTokens{};
+    std::array<uint64_t, kindCount> kindBytes{};
+    std::array<uint64_t, phaseCount> phaseNanos{};
+    std::array<uint64_t, bucketCount> latency{};
+
+    uint64_t rawTokens = 0;
+    uint64_t sampledTokens = 0;
+    uint64_t sampledNanos = 0;
+    uint64_t sampledReportNanos = 0;
+    uint64_t inputBytes = 0;
+    uint64_t tokenCount = 0;
+    uint64_t wallNanos = 0;
+    uint64_t clockNanos = 0;
+    Clock::time_point runStart;
+
+    static const char* phaseName(size_t phase);
+    static const char* kindName(size_t kind);
+
+public:
+    static uint64_t nanosSince(Clock::time_point start)
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+    }
+
+    void setSampleInterval(unsigned every) { sampleEvery = every > 0 ? every : 1; }
+    void begin();
+    uint64_t* phaseCounter(LexPhase phase) { return &phaseNanos[static_cast<size_t>(phase)]; }
+    void finish(const TokenStream& tokens, size_t bytes);
+
+    // Called once per token the scanner hands to classification; true for the tokens to time
+    bool sampleNext()
+    {
+        ++rawTokens;
+        if (--countdown != 0)
+            return false;
+        countdown = sampleEvery;
+        return true;
+    }
+    void recordToken(uint64_t nanos, uint64_t reportNanos, unsigned reportSpans);
+
+    uint64_t tokens(TokenKind kind) const { return kindTokens[static_cast<size_t>(kind)]; }
+    uint64_t bytes(TokenKind kind) const { return kindBytes[static_cast<size_t>(kind)]; }
+    uint64_t phase(LexPhase phase) const { return phaseNanos[static_cast<size_t>(phase)]; }
+    uint64_t bucket(size_t index) const { return latency[index]; }
+    uint64_t percentileNanos(double fraction) const;
+    uint64_t totalNanos() const { return wallNanos; }
+    double bytesPerSecond() const { return wallNanos ? inputBytes * 1e9 / wallNanos : 0.0; }
+    double tokensPerSecond() const { return wallNanos ? tokenCount * 1e9 / wallNanos : 0.0; }
+
+    std::string toJson() const;
+    bool writeJson(const std::string& fileName) const;
+};
+
+/* <summary>
+This function starts a run: all statistics are cleared, the cost of one clock read is measured (the least of a few back-to-back reads) and the run clock starts.
+</summary>*/
+void LexerMetrics::begin()
+{
+    kindTokens.fill(0);
+    kindBytes.fill(0);
+    phaseNanos.fill(0);
+    latency.fill(0);
+    rawTokens = sampledTokens = sampledNanos = sampledReportNanos = 0;
+    inputBytes = tokenCount = wallNanos = 0;
+    countdown = 1;
+
+    clockNanos = UINT64_MAX;
+    for (int i = 0; i < 16; ++i)
+    {
+        Clock::time_point start = Clock::now();
+        uint64_t nanos = nanosSince(start);
+        clockNanos = nanos < clockNanos ? nanos : clockNanos;
+    }
+    runStart = Clock::now();
+}
+
+/* <summary>
+This function records one sampled token: `nanos` for the whole token, `reportNanos` of it for its report lines, timed in `reportSpans` spans. The clock reads are taken out: one in every span, and one for the token plus two per report span in the whole.
+</summary>*/
+void LexerMetrics::recordToken(uint64_t nanos, uint64_t reportNanos, unsigned reportSpans)
+{
+    const uint64_t reportReads = clockNanos * reportSpans;
+    const uint64_t tokenReads = clockNanos * (1 + 2 * uint64_t(reportSpans));
+    reportNanos = reportNanos > reportReads ? reportNanos - reportReads : 0;
+    nanos = nanos > tokenReads ? nanos - tokenReads : 0;
+    nanos = nanos > reportNanos ? nanos : reportNanos;
+
+    ++sampledTokens;
+    sampledNanos += nanos;
+    sampledReportNanos += reportNanos;
+
+    size_t index = 0;
+    while (index + 1 < bucketCount && (nanos >> (index + 1)) != 0)
+        ++index;
+    ++latency[index];
+}
+
+/* <summary>
+This function ends a run.
+
+Logic:
+1. Count the tokens and lexeme bytes per class from the columns of the token stream.
+2. Scale the sampled token times to all tokens: the report time is `Report`, the rest `Classify`. Both are part of the measured `Scan` time, so they are taken out of it (never below zero).
+3. Stop the run clock.
+</summary>*/
+void LexerMetrics::finish(const TokenStream& tokens, size_t bytes)
+{
+    const TokenKind* kinds = tokens.kindData();
+    const uint32_t* lengths = tokens.lengthData();
+    for (size_t i = 0; i < tokens.size(); ++i)
+    {
+        ++kindTokens[static_cast<size_t>(kinds[i])];
+        kindBytes[static_cast<size_t>(kinds[i])] += lengths[i];
+    }
+    tokenCount = tokens.size();
+    inputBytes = bytes;
+
+    if (sampledTokens > 0)
+    {
+        const double scale = static_cast<double>(rawTokens) / static_cast<double>(sampledTokens);
+        const uint64_t report = static_cast<uint64_t>(sampledReportNanos * scale);
+        const uint64_t classify = static_cast<uint64_t>((sampledNanos - sampledReportNanos) * scale);
+        uint64_t& scan = phaseNanos[static_cast<size_t>(LexPhase::Scan)];
+        scan = scan > report + classify ? scan - report - classify : 0;
+        phaseNanos[static_cast<size_t>(LexPhase::Classify)] += classify;
+        phaseNanos[static_cast<size_t>(LexPhase::Report)] += report;
+    }
+    wallNanos = nanosSince(runStart);
+}
+
+/* <summary>
+This function returns the upper bound, in nanoseconds, of the histogram bucket that holds the given fraction (0 to 1) of the sampled tokens, or 0 without samples.
+</summary>*/
+uint64_t LexerMetrics::percentileNanos(double fraction) const
+{
+    if (sampledTokens == 0)
+        return 0;
+    uint64_t rank = static_cast<uint64_t>(fraction * static_cast<double>(sampledTokens - 1)) + 1;
+    uint64_t seen = 0;
+    for (size_t index = 0; index < bucketCount; ++index)
+    {
+        seen += latency[index];
+        if (seen >= rank)
+            return (uint64_t(1) << (index + 1)) - 1;
+    }
+    return UINT64_MAX;
+}
+
+const char* LexerMetrics::phaseName(size_t phase)
+{
+    static const char* const names[phaseCount] = { "read", "scan", "classify", "report", "write" };
+    return names[phase];
+}
+
+const char* LexerMetrics::kindName(size_t kind)
+{
+    static const char* const names[kindCount] = { "keyword", "identifier", "number", "punctuation", "operator", "invalid" };
+    return names[kind];
+}
+
+/* <summary>
+This function formats the statistics as one line of JSON: `bytes`, `tokens`, `seconds`, `bytesPerSecond`, `tokensPerSecond`, `classes` (tokens and bytes per class), `phasesNs`, and `latency` (sample interval, sampled tokens, p50/p90/p99 and the non-empty buckets as `[upper bound, count]` pairs).
+</summary>*/
+std::string LexerMetrics::toJson() const
+{
+    std::string json;
+    char number[64];
+    auto integer = [&json, &number](uint64_t value)
+    {
+        std::snprintf(number, sizeof(number), "%llu", static_cast<unsigned long long>(value));
+        json += number;
+    };
+    auto real = [&json, &number](double value)
+    {
+        std::snprintf(number, sizeof(number), "%.6g", value);
+        json += number;
+    };
+
+    json += "{\"bytes\":";
+    integer(inputBytes);
+    json += ",\"tokens\":";
+    integer(tokenCount);
+    json += ",\"seconds\":";
+    real(wallNanos / 1e9);
+    json += ",\"bytesPerSecond\":";
+    real(bytesPerSecond());
+    json += ",\"tokensPerSecond\":";
+    real(tokensPerSecond());
+
+    json += ",\"classes\":{";
+    for (size_t kind = 0; kind < kindCount; ++kind)
+    {
+        json += kind ? ",\"" : "\"";
+        json += kindName(kind);
+        json += "\":{\"tokens\":";
+        integer(kindTokens[kind]);
+        json += ",\"bytes\":";
+        integer(kindBytes[kind]);
+        json += "}";
+    }
+
+    json += "},\"phasesNs\":{";
+    for (size_t phase = 0; phase < phaseCount; ++phase)
+    {
+        json += phase ? ",\"" : "\"";
+        json += phaseName(phase);
+        json += "\":";
+        integer(phaseNanos[phase]);
+    }
+
+    json += "},\"latency\":{\"sampleEvery\":";
+    integer(sampleEvery);
+    json += ",\"samples\":";
+    integer(sampledTokens);
+    json += ",\"p50Ns\":";
+    integer(percentileNanos(0.5));
+    json += ",\"p90Ns\":";
+    integer(percentileNanos(0.9));
+    json += ",\"p99Ns\":";
+    integer(percentileNanos(0.99));
+    json += ",\"bucketsNs\":[";
+    bool first = true;
+    for (size_t index = 0; index < bucketCount; ++index)
+    {
+        if (latency[index] == 0)
+            continue;
+        json += first ? "[" : ",[";
+        integer((uint64_t(1) << (index + 1)) - 1);
+        json += ",";
+        integer(latency[index]);
+        json += "]";
+        first = false;
+    }
+    json += "]}}";
+    return json;
+}
+
+/* <summary>
+This function writes `toJson` and a newline to a file, replacing it. It returns `false` if the file cannot be written.
+</summary>*/
+bool LexerMetrics::writeJson(const std::string& fileName) const
+{
+    std::ofstream file(fileName);
+    if (!file.is_open())
+        return false;
+    file << toJson() << "\n";
+    return static_cast<bool>(file);
+}
+
+#endif // LEXER_METRICS_H
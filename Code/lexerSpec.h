@@ -0,0 +1,721 @@
+﻿#ifndef LEXER_SPEC_H
+#define LEXER_SPEC_H
+
+#include <algorithm>
+#include <bitset>
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "tokenStream.h"
+
+/* <summary>
+The `LexerDFA` struct is the compiled form of a lexer specification: one minimized DFA over all token classes of the specification.
+
+Logic:
+1. `classOf` maps every byte to a character class. Two bytes share a class when no pattern tells them apart, so the table has one column per class rather than 256.
+2. `transitions` is the flattened transition table, indexed by `state * classCount + class`. State 0 is the start state; `-1` means no token can continue (the dead state is not stored).
+3. `acceptRule` gives the rule a state accepts (`-1` for non-accepting states) and `accept` the token kind of that rule, so the scanner needs one load per byte whatever the number of rules.
+</summary>*/
+struct LexerDFA
+{
+    unsigned char classOf[256] = {};
+    int classCount = 0;
+    std::vector<int> transitions;
+    std::vector<TokenKind> accept;
+    std::vector<int> acceptRule;
+    std::vector<std::string> ruleNames;
+
+    int stateCount() const { return static_cast<int>(accept.size()); }
+};
+
+/* <summary>
+The `LexerSpec` class reads a lexer specification and compiles it into a `LexerDFA`.
+
+Logic:
+1. A specification is a text file with one rule per line: `<name> <kind> <priority> <pattern>`. `kind` is one of `keyword`, `identifier`, `number`, `punctuation` and `operator` and is the `TokenKind` the rule's tokens are reported as; several rules may share a kind. Empty lines and lines starting with `#` are ignored.
+2. Patterns are regular expressions over bytes: literals, `.` (any byte but a newline), `[...]` sets with ranges and `^` negation, `\d`, `\w`, `\s`, the escapes `\n`, `\t`, `\r` and `\` before any other character to take it literally, grouping with `(...)`, alternation `|` and the postfix operators `*`, `+` and `?`.
+3. `compile` builds one Thompson NFA for all rules, determinizes it by subset construction and minimizes the result with Hopcroft's algorithm.
+4. When several rules accept the same lexeme, the one with the higher priority wins; on equal priority the rule that comes first in the file wins.
+5. Errors are reported on `std::cerr` with the line of the rule, and the function returns `false`.
+</summary>*/
+class LexerSpec
+{
+public:
+    struct Rule
+    {
+        std::string name;
+        TokenKind kind = TokenKind::Invalid;
+        int priority = 0;
+        std::string pattern;
+    };
+
+private:
+    // NFA state: at most one byte-set edge (Thompson construction) plus epsilon edges
+    struct NfaState
+    {
+        std::bitset<256> on;
+        int next = -1;
+        std::vector<int> epsilon;
+        int rule = -1;
+    };
+
+    // Start and end state of a sub-automaton
+    struct Fragment
+    {
+        int start;
+        int end;
+    };
+
+    std::vector<Rule> rules;
+    std::vector<int> ruleLines;
+
+    // NFA under construction and pattern parser state
+    std::vector<NfaState> nfa;
+    std::string_view pattern;
+    size_t pos = 0;
+    std::string parseError;
+
+    int addState();
+    Fragment byteSet(const std::bitset<256>& set);
+    Fragment parseAlternation();
+    Fragment parseConcatenation();
+    Fragment parseRepetition();
+    Fragment parseAtom();
+    bool parseEscape(std::bitset<256>& set);
+    bool parseSet(std::bitset<256>& set);
+
+    void closure(std::vector<int>& states) const;
+    int betterRule(int current, int candidate) const;
+    static void minimize(LexerDFA& dfa);
+
+public:
+    bool load(const std::string& fileName);
+    bool parse(std::string_view text);
+    bool compile(LexerDFA& dfa);
+    const std::vector<Rule>& getRules() const { return rules; }
+};
+
+// |-------------------------------------------------------------------------------------------------------------|
+// |                                           Specification Parser                                              |
+// |-------------------------------------------------------------------------------------------------------------|
+
+/* <summary>
+This function reads a specification file and parses it (see `parse`).
+</summary>*/
+bool LexerSpec::load(const std::string& fileName)
+{
+    std::ifstream input(fileName, std::ios::binary);
+    if (!input.is_open())
+    {
+        std::cerr << "Error opening lexer specification " << fileName << ".\n";
+        return false;
+    }
+    std::stringstream content;
+    content << input.rdbuf();
+    return parse(content.str());
+}
+
+/* <summary>
+This function parses the rules of a specification.
+
+Logic:
+1. Split the text into lines and skip empty lines and comments.
+2. Read the name, the kind and the priority; the rest of the line, without surrounding blanks, is the pattern.
+3. Check the kind and that a pattern is present. The patterns themselves are checked by `compile`.
+</summary>*/
+bool LexerSpec::parse(std::string_view text)
+{
+    static const std::pair<std::string_view, TokenKind> kinds[] =
+    {
+        { "keyword", TokenKind::Keyword }, { "identifier", TokenKind::Identifier }, { "number", TokenKind::Number },
+        { "punctuation", TokenKind::Punctuation }, { "operator", TokenKind::Operator }
+    };
+
+    rules.clear();
+    ruleLines.clear();
+    int lineNum = 0;
+    size_t start = 0;
+    while (start < text.size())
+    {
+        size_t end = text.find('\n', start);
+        if (end == std::string_view::npos)
+            end = text.size();
+        std::string line(text.substr(start, end - start));
+        start = end + 1;
+        lineNum++;
+
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        size_t first = line.find_first_not_of(" \t");
+        if (first == std::string::npos || line[first] == '#')
+            continue;
+
+        std::istringstream fields(line);
+        Rule rule;
+        std::string kind;
+        if (!(fields >> rule.name >> kind >> rule.priority))
+        {
+            std::cerr << "Error: lexer specification line " << lineNum << ": expected <name> <kind> <priority> <pattern>.\n";
+            return false;
+        }
+        auto match = std::find_if(std::begin(kinds), std::end(kinds), [&kind](const auto& entry) { return entry.first == kind; });
+        if (match == std::end(kinds))
+        {
+            std::cerr << "Error: lexer specification line " << lineNum << ": unknown token kind " << kind << ".\n";
+            return false;
+        }
+        rule.kind = match->second;
+
+        std::string rest;
+        std::getline(fields, rest);
+        size_t patternStart = rest.find_first_not_of(" \t");
+        size_t patternEnd = rest.find_last_not_of(" \t");
+        if (patternStart == std::string::npos)
+        {
+            std::cerr << "Error: lexer specification line " << lineNum << ": rule " << rule.name << " has no pattern.\n";
+            return false;
+        }
+        rule.pattern = rest.substr(patternStart, patternEnd - patternStart + 1);
+        rules.push_back(rule);
+        ruleLines.push_back(lineNum);
+    }
+
+    if (rules.empty())
+    {
+        std::cerr << "Error: lexer specification has no rules.\n";
+        return false;
+    }
+    return true;
+}
+
+// |-------------------------------------------------------------------------------------------------------------|
+// |                                        Regular Expressions to NFA                                           |
+// |-------------------------------------------------------------------------------------------------------------|
+
+int LexerSpec::addState()
+{
+    nfa.emplace_back();
+    return static_cast<int>(nfa.size()) - 1;
+}
+
+// Two states joined by one edge on `set`
+LexerSpec::Fragment LexerSpec::byteSet(const std::bitset<256>& set)
+{
+    int start = addState();
+    int end = addState();
+    nfa[start].on = set;
+    nfa[start].next = end;
+    return { start, end };
+}
+
+/* <summary>
+These functions parse a pattern by recursive descent and build its Thompson NFA on the way.
+
+Logic:
+1. alternation := concatenation ('|' concatenation)*: a new start state with epsilon edges to every alternative and epsilon edges from their ends to a new end state.
+2. concatenation := repetition*: the end of each part gets an epsilon edge to the start of the next one. An empty concatenation is a single state, i.e. matches the empty string.
+3. repetition := atom ('*' | '+' | '?')*: the usual loop and bypass epsilon edges around the atom.
+4. atom := '(' alternation ')' | '[' set ']' | '.' | '\' escape | any other byte.
+5. The first error is kept in `parseError`; parsing stops there.
+</summary>*/
+LexerSpec::Fragment LexerSpec::parseAlternation()
+{
+    Fragment first = parseConcatenation();
+    if (pos >= pattern.size() || pattern[pos] != '|' || !parseError.empty())
+        return first;
+
+    int start = addState();
+    int end = addState();
+    nfa[start].epsilon.push_back(first.start);
+    nfa[first.end].epsilon.push_back(end);
+    while (pos < pattern.size() && pattern[pos] == '|' && parseError.empty())
+    {
+        pos++;
+        Fragment next = parseConcatenation();
+        nfa[start].epsilon.push_back(next.start);
+        nfa[next.end].epsilon.push_back(end);
+    }
+    return { start, end };
+}
+
+LexerSpec::Fragment LexerSpec::parseConcatenation()
+{
+    int start = addState();
+    Fragment result{ start, start };
+    while (pos < pattern.size() && pattern[pos] != '|' && pattern[pos] != ')' && parseError.empty())
+    {
+        Fragment next = parseRepetition();
+        nfa[result.end].epsilon.push_back(next.start);
+        result.end = next.end;
+    }
+    return result;
+}
+
+LexerSpec::Fragment LexerSpec::parseRepetition()
+{
+    Fragment atom = parseAtom();
+    while (pos < pattern.size() && parseError.empty() && (pattern[pos] == '*' || pattern[pos] == '+' || pattern[pos] == '?'))
+    {
+        char op = pattern[pos++];
+        int start = addState();
+        int end = addState();
+        nfa[start].epsilon.push_back(atom.start);
+        nfa[atom.end].epsilon.push_back(end);
+        if (op != '+')
+            nfa[start].epsilon.push_back(end);
+        if (op != '?')
+            nfa[atom.end].epsilon.push_back(atom.start);
+        atom = { start, end };
+    }
+    return atom;
+}
+
+LexerSpec::Fragment LexerSpec::parseAtom()
+{
+    std::bitset<256> set;
+    char c = pattern[pos++];
+    switch (c)
+    {
+    case '(':
+    {
+        Fragment inner = parseAlternation();
+        if (pos >= pattern.size() || pattern[pos] != ')')
+        {
+            if (parseError.empty())
+                parseError = "missing ')'";
+            return inner;
+        }
+        pos++;
+        return inner;
+    }
+    case '[':
+        parseSet(set);
+        return byteSet(set);
+    case '.':
+        set.set();
+        set.reset('\n');
+        return byteSet(set);
+    case '\\':
+        parseEscape(set);
+        return byteSet(set);
+    case '*':
+    case '+':
+    case '?':
+        parseError = std::string("nothing to repeat before '") + c + "'";
+        return byteSet(set);
+    default:
+        set.set(static_cast<unsigned char>(c));
+        return byteSet(set);
+    }
+}
+
+// The bytes of the escape after a '\'
+bool LexerSpec::parseEscape(std::bitset<256>& set)
+{
+    if (pos >= pattern.size())
+    {
+        parseError = "pattern ends with '\\'";
+        return false;
+    }
+    char c = pattern[pos++];
+    switch (c)
+    {
+    case 'n':
+        set.set('\n');
+        break;
+    case 't':
+        set.set('\t');
+        break;
+    case 'r':
+        set.set('\r');
+        break;
+    case 'd':
+        for (int b = '0'; b <= '9'; ++b)
+            set.set(b);
+        break;
+    case 'w':
+        for (int b = 0; b < 256; ++b)
+            if ((b >= 'a' && b <= 'z') || (b >= 'A' && b <= 'Z') || (b >= '0' && b <= '9') || b == '_')
+                set.set(b);
+        break;
+    case 's':
+        for (char b : std::string_view(" \t\n\v\f\r"))
+            set.set(static_cast<unsigned char>(b));
+        break;
+    default:
+        set.set(static_cast<unsigned char>(c));
+        break;
+    }
+    return true;
+}
+
+// The bytes of a '[...]' set; `pos` is just after the '['
+bool LexerSpec::parseSet(std::bitset<256>& set)
+{
+    bool negate = pos < pattern.size() && pattern[pos] == '^';
+    if (negate)
+        pos++;
+
+    bool firstItem = true;
+    while (pos < pattern.size() && (pattern[pos] != ']' || firstItem))
+    {
+        firstItem = false;
+        std::bitset<256> item;
+        int low = -1;
+        if (pattern[pos] == '\\')
+        {
+            pos++;
+            if (!parseEscape(item))
+                return false;
+            if (item.count() == 1)
+                for (int b = 0; b < 256 && low < 0; ++b)
+                    if (item[b])
+                        low = b;
+        }
+        else
+        {
+            low = static_cast<unsigned char>(pattern[pos++]);
+            item.set(low);
+        }
+
+        // A range `a-z`; a '-' at the end of the set is literal
+        if (low >= 0 && pos + 1 < pattern.size() && pattern[pos] == '-' && pattern[pos + 1] != ']')
+        {
+            pos++;
+            int high = -1;
+            if (pattern[pos] == '\\')
+            {
+                pos++;
+                std::bitset<256> bound;
+                if (!parseEscape(bound))
+                    return false;
+                if (bound.count() != 1)
+                {
+                    parseError = "range in '[...]' ends with a class escape";
+                    return false;
+                }
+                for (int b = 0; b < 256 && high < 0; ++b)
+                    if (bound[b])
+                        high = b;
+            }
+            else
+            {
+                high = static_cast<unsigned char>(pattern[pos++]);
+            }
+            if (high < low)
+            {
+                parseError = "reversed range in '[...]'";
+                return false;
+            }
+            for (int b = low; b <= high; ++b)
+                item.set(b);
+        }
+        set |= item;
+    }
+
+    if (pos >= pattern.size())
+    {
+        parseError = "missing ']'";
+        return false;
+    }
+    pos++;
+    if (negate)
+        set.flip();
+    return true;
+}
+
+// |-------------------------------------------------------------------------------------------------------------|
+// |                                      Subset Construction and Minimization                                   |
+// |-------------------------------------------------------------------------------------------------------------|
+
+// Extends a set of NFA states by everything reachable over epsilon edges and sorts it
+void LexerSpec::closure(std::vector<int>& states) const
+{
+    std::vector<bool> seen(nfa.size(), false);
+    for (int s : states)
+        seen[s] = true;
+    for (size_t i = 0; i < states.size(); ++i)
+    {
+        for (int t : nfa[states[i]].epsilon)
+        {
+            if (!seen[t])
+            {
+                seen[t] = true;
+                states.push_back(t);
+            }
+        }
+    }
+    std::sort(states.begin(), states.end());
+}
+
+// The rule that wins when both accept: higher priority, then earlier in the file
+int LexerSpec::betterRule(int current, int candidate) const
+{
+    if (current < 0)
+        return candidate;
+    if (rules[candidate].priority != rules[current].priority)
+        return rules[candidate].priority > rules[current].priority ? candidate : current;
+    return std::min(current, candidate);
+}
+
+/* <summary>
+This function compiles the rules into a minimized DFA.
+
+Logic:
+1. Build the NFA: a common start state with an epsilon edge to the NFA of every rule, whose end state is marked with the rule.
+2. Compute the character classes: start with all bytes in one class and split the classes by every byte set of the NFA, so bytes that no edge tells apart share a class. Subset construction then works per class instead of per byte.
+3. Subset construction: DFA states are epsilon-closed sets of NFA states, found by a worklist from the closure of the start state. For each class, the successor is the closure of the states reached on the class's first byte; the empty set is the dead state (`-1`). A DFA state accepts the best rule among its NFA states (`betterRule`).
+4. Minimize with Hopcroft's algorithm (`minimize`).
+</summary>*/
+bool LexerSpec::compile(LexerDFA& dfa)
+{
+    // Step 1: one NFA for all rules
+    nfa.clear();
+    int start = addState();
+    for (size_t r = 0; r < rules.size(); ++r)
+    {
+        pattern = rules[r].pattern;
+        pos = 0;
+        parseError.clear();
+        Fragment fragment = parseAlternation();
+        if (parseError.empty() && pos < pattern.size())
+            parseError = "unmatched ')'";
+        if (!parseError.empty())
+        {
+            std::cerr << "Error: lexer specification line " << ruleLines[r] << ": " << parseError << " in pattern of rule " << rules[r].name << ".\n";
+            return false;
+        }
+        nfa[start].epsilon.push_back(fragment.start);
+        nfa[fragment.end].rule = static_cast<int>(r);
+    }
+
+    // Step 2: character classes
+    int classOf[256] = {};
+    int classCount = 1;
+    for (const NfaState& state : nfa)
+    {
+        if (state.next < 0)
+            continue;
+        std::map<std::pair<int, bool>, int> split;
+        int newCount = 0;
+        for (int b = 0; b < 256; ++b)
+        {
+            auto key = std::make_pair(classOf[b], static_cast<bool>(state.on[b]));
+            auto found = split.emplace(key, newCount);
+            if (found.second)
+                newCount++;
+            classOf[b] = found.first->second;
+        }
+        classCount = newCount;
+    }
+    std::vector<int> representative(classCount, -1);
+    for (int b = 255; b >= 0; --b)
+        representative[classOf[b]] = b;
+
+    // Step 3: subset construction
+    dfa = LexerDFA();
+    dfa.classCount = classCount;
+    for (int b = 0; b < 256; ++b)
+        dfa.classOf[b] = static_cast<unsigned char>(classOf[b]);
+    for (const Rule& rule : rules)
+        dfa.ruleNames.push_back(rule.name);
+
+    std::map<std::vector<int>, int> stateIds;
+    std::vector<std::vector<int>> subsets;
+    std::vector<int> initial{ start };
+    closure(initial);
+    stateIds.emplace(initial, 0);
+    subsets.push_back(initial);
+
+    for (size_t d = 0; d < subsets.size(); ++d)
+    {
+        int rule = -1;
+        for (int s : subsets[d])
+            if (nfa[s].rule >= 0)
+                rule = betterRule(rule, nfa[s].rule);
+        dfa.acceptRule.push_back(rule);
+
+        for (int cls = 0; cls < classCount; ++cls)
+        {
+            std::vector<int> target;
+            for (int s : subsets[d])
+                if (nfa[s].next >= 0 && nfa[s].on[representative[cls]])
+                    target.push_back(nfa[s].next);
+            if (target.empty())
+            {
+                dfa.transitions.push_back(-1);
+                continue;
+            }
+            closure(target);
+            target.erase(std::unique(target.begin(), target.end()), target.end());
+            auto found = stateIds.emplace(target, static_cast<int>(subsets.size()));
+            if (found.second)
+                subsets.push_back(target);
+            dfa.transitions.push_back(found.first->second);
+        }
+    }
+    nfa.clear();
+
+    // Step 4: minimization
+    minimize(dfa);
+    for (int rule : dfa.acceptRule)
+        dfa.accept.push_back(rule >= 0 ? rules[rule].kind : TokenKind::Invalid);
+    return true;
+}
+
+/* <summary>
+This function minimizes a DFA with Hopcroft's algorithm and renumbers its states.
+
+Logic:
+1. Make the DFA complete with an explicit dead state, so every state has a successor on every class.
+2. Start from the partition by accepted rule (all non-accepting states, including the dead state, form one block). States that accept different rules are never merged, so the rule priorities survive minimization.
+3. Worklist of (block, class) splitters, initially every block with every class. For a splitter, find all states whose successor on the class lies in the block (using the inverse transitions) and split every block that has such states and others. If the split block was still waiting in the worklist for a class, both halves are added for it; otherwise only the smaller half, which is what keeps the algorithm at O(n log n) per class.
+4. The block of the dead state becomes `-1` again: it also absorbs the states from which no token can be accepted any more, so the scanner stops as early as possible. The other blocks are numbered in breadth-first order from the start state.
+</summary>*/
+void LexerSpec::minimize(LexerDFA& dfa)
+{
+    const int classCount = dfa.classCount;
+    const int dead = static_cast<int>(dfa.acceptRule.size());
+    const int stateCount = dead + 1;
+
+    // Step 1: complete DFA
+    std::vector<int> next(static_cast<size_t>(stateCount) * classCount, dead);
+    for (int s = 0; s < dead; ++s)
+        for (int cls = 0; cls < classCount; ++cls)
+            if (dfa.transitions[s * classCount + cls] >= 0)
+                next[s * classCount + cls] = dfa.transitions[s * classCount + cls];
+
+    std::vector<std::vector<int>> inverse(static_cast<size_t>(stateCount) * classCount);
+    for (int s = 0; s < stateCount; ++s)
+        for (int cls = 0; cls < classCount; ++cls)
+            inverse[next[s * classCount + cls] * classCount + cls].push_back(s);
+
+    // Step 2: initial partition by accepted rule
+    std::vector<int> blockOf(stateCount);
+    std::vector<std::vector<int>> blocks;
+    std::map<int, int> blockOfRule;
+    for (int s = 0; s < stateCount; ++s)
+    {
+        int rule = s < dead ? dfa.acceptRule[s] : -1;
+        auto found = blockOfRule.emplace(rule, static_cast<int>(blocks.size()));
+        if (found.second)
+            blocks.emplace_back();
+        blockOf[s] = found.first->second;
+        blocks[blockOf[s]].push_back(s);
+    }
+
+    // Step 3: refine
+    std::vector<std::pair<int, int>> worklist;
+    std::vector<std::vector<char>> waiting;
+    for (int b = 0; b < static_cast<int>(blocks.size()); ++b)
+    {
+        waiting.emplace_back(classCount, 1);
+        for (int cls = 0; cls < classCount; ++cls)
+            worklist.emplace_back(b, cls);
+    }
+
+    std::vector<char> marked(stateCount, 0);
+    std::vector<std::vector<int>> touched;
+    while (!worklist.empty())
+    {
+        auto [splitter, cls] = worklist.back();
+        worklist.pop_back();
+        waiting[splitter][cls] = 0;
+
+        std::vector<int> touchedBlocks;
+        touched.resize(blocks.size());
+        for (int target : blocks[splitter])
+        {
+            for (int s : inverse[target * classCount + cls])
+            {
+                if (marked[s])
+                    continue;
+                marked[s] = 1;
+                int b = blockOf[s];
+                if (touched[b].empty())
+                    touchedBlocks.push_back(b);
+                touched[b].push_back(s);
+            }
+        }
+
+        for (int b : touchedBlocks)
+        {
+            std::vector<int> inside = std::move(touched[b]);
+            touched[b].clear();
+            for (int s : inside)
+                marked[s] = 0;
+            if (inside.size() == blocks[b].size())
+                continue;
+
+            int newBlock = static_cast<int>(blocks.size());
+            std::vector<int> outside;
+            for (int s : inside)
+                blockOf[s] = newBlock;
+            for (int s : blocks[b])
+                if (blockOf[s] == b)
+                    outside.push_back(s);
+            blocks[b] = std::move(outside);
+            blocks.push_back(std::move(inside));
+            waiting.emplace_back(classCount, 0);
+            touched.resize(blocks.size());
+
+            for (int c = 0; c < classCount; ++c)
+            {
+                int add = waiting[b][c] || blocks[newBlock].size() < blocks[b].size() ? newBlock : b;
+                if (!waiting[add][c])
+                {
+                    waiting[add][c] = 1;
+                    worklist.emplace_back(add, c);
+                }
+            }
+        }
+    }
+
+    // Step 4: renumber from the start state, dropping the dead block
+    const int deadBlock = blockOf[dead];
+    std::vector<int> number(blocks.size(), -1);
+    std::vector<int> order;
+    if (blockOf[0] != deadBlock)
+    {
+        number[blockOf[0]] = 0;
+        order.push_back(blockOf[0]);
+    }
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        int s = blocks[order[i]].front();
+        for (int c = 0; c < classCount; ++c)
+        {
+            int b = blockOf[next[s * classCount + c]];
+            if (b != deadBlock && number[b] < 0)
+            {
+                number[b] = static_cast<int>(order.size());
+                order.push_back(b);
+            }
+        }
+    }
+
+    // A specification that accepts nothing still gets a start state
+    std::vector<int> transitions;
+    std::vector<int> acceptRule;
+    if (order.empty())
+    {
+        transitions.assign(classCount, -1);
+        acceptRule.push_back(-1);
+    }
+    for (int b : order)
+    {
+        int s = blocks[b].front();
+        acceptRule.push_back(dfa.acceptRule[s]);
+        for (int c = 0; c < classCount; ++c)
+            transitions.push_back(number[blockOf[next[s * classCount + c]]]);
+    }
+    dfa.transitions = std::move(transitions);
+    dfa.acceptRule = std::move(acceptRule);
+}
+
+#endif // LEXER_SPEC_H
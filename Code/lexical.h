@@ -1,4 +1,4 @@
-#ifndef LEXICAL_H
+﻿#ifndef LEXICAL_H
 #define LEXICAL_H
 
 #include <iostream>
@@ -6,16 +6,62 @@
 #include <fstream>
 #include <cctype>
 #include <string>
-#include <unordered_set>
-#include <unordered_map>
+#include <vector>
+#include <array>
+#include <map>
+#include <string_view>
+#include <type_traits>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <thread>
+#include <future>
+#include <memory>
+#include "sourceBuffer.h"
+#include "tokenStream.h"
+#include "binaryTokenFile.h"
+#include "threadPool.h"
+#include "delimiterScan.h"
+#include "reportWriter.h"
+#include "diagnostics.h"
+#include "lexerSpec.h"
+#include "lexerMetrics.h"
+#ifdef LEXICAL_DIRECT_CODED
+#include "directScanner.h"
+#endif
+
+/* <summary>
+The `ScannerDefinition` struct is the immutable part of a scanner: everything `Lexical` derives from its tables or loads once and then only reads while scanning. Any number of `Lexical` instances, on any number of threads, share one definition through a `std::shared_ptr<const ScannerDefinition>`; the state of a run (counters, token stream, report files) stays in the instance.
+
+Logic:
+1. The merged (product) DFA is built by `Lexical::buildMergedDFA` from `identifierTable`, `numberTable`, `punctuationTable` and `operatorTable`:
+   - `mergedClass` maps every byte to a merged character class. Two bytes share a class when all four column-mapping functions put them in the same column, so the class count stays small (about 25).
+   - Each merged state stands for the tuple of states the four machines would be in after reading the same prefix. State 0 is the tuple of start states; a tuple in which every machine has rejected is not stored and shows up as `-1` in `mergedTransitions`.
+   - `mergedTransitions` is the flattened transition table, indexed by `state * mergedClassCount + class`.
+   - `mergedAccept` gives the token kind a state accepts (`TokenKind::Invalid` for non-accepting states). When several machines accept, the cascade's priority is kept: identifier, number, punctuation, operator.
+   - `mergedKeywordCandidate` marks the states in which the identifier machine has seen only letters and digits after a letter (S2); a lexeme ending there is checked with `isKeyword`.
+2. `specDFA` is the DFA compiled from a lexer specification (`Lexical::loadLexerSpec`), or empty.
+3. The keywords and the per-machine tables are compile-time constants of `Lexical` and need no place here.
+</summary>*/
+struct ScannerDefinition
+{
+    unsigned char mergedClass[256] = {};
+    int mergedClassCount = 0;
+    std::vector<int> mergedTransitions;
+    std::vector<TokenKind> mergedAccept;
+    std::vector<bool> mergedKeywordCandidate;
+
+    std::shared_ptr<const LexerDFA> specDFA;
+};
 
 class Lexical
 {
 private:
-    // Files to be created
-    std::ofstream tokenFile;
-    std::ofstream symbolTableFile;
-    std::ofstream errorFile;
+    // Files to be created, and the console log, written through large buffers (see `ReportWriter`)
+    ReportWriter tokenFile;
+    ReportWriter symbolTableFile;
+    ReportWriter errorFile;
+    ReportWriter console;
 
     // Count
     int tokenNo = 0;
@@ -26,6 +72,10 @@ private:
     int nOperators = 0;
     int nInvalid = 0;
 
+    // Tokens of the last run, in the order they are reported, and the scratch stream `relex` lexes an edited range into
+    TokenStream tokens;
+    TokenStream relexTokens;
+
     // Common column widths for formatting
     const int colWidthToken = 20;
     const int colWidthType = 20;
@@ -33,7 +83,7 @@ private:
     const int colWidthTokenNo = 10;
 
     // All valid keywords
-    std::unordered_set<std::string> keywords =
+    static constexpr std::string_view keywords[] =
     {
         "loop", "agar", "magar", "asm", "else", "new", "this", "auto",
         "enum", "operator", "throw", "bool", "explicit", "private", "true",
@@ -46,6 +96,29 @@ private:
         "switch", "while", "namespace"
     };
 
+    /* <summary>
+    This is the perfect hash over `keywords` that `isKeyword` uses. It is generated at compile time by `buildKeywordHash`, so editing the keyword list regenerates it.
+
+    Logic:
+    1. A token is reduced to a 32-bit key made of its length, its first two characters and its last character (`keywordKey`).
+    2. The key is multiplied by `seed` and the top `keywordHashBits` bits select a slot. `seed` is chosen so that no two keywords share a slot.
+    3. A slot holds the keyword's index plus one, or `0` when it is empty. A lookup is therefore one multiply, one load and, on a hit, one length check and one `memcmp`.
+    </summary>*/
+    static constexpr int keywordHashBits = 9;
+    static constexpr size_t keywordMaxLength = 16;
+
+    struct KeywordHash
+    {
+        uint32_t seed = 0;
+        unsigned char slots[1 << keywordHashBits] = {};
+    };
+
+    static const KeywordHash keywordHash;
+
+    static constexpr uint32_t keywordKey(std::string_view token);
+    static constexpr uint32_t keywordSlot(uint32_t key, uint32_t seed);
+    static constexpr KeywordHash buildKeywordHash();
+
     // Transition Tables
 
     /* <summary>
@@ -84,7 +157,7 @@ private:
     4. The FSM accepts the token as a valid identifier if it reaches state S2 or S3, indicating that the identifier follows the rules: it starts with a letter or underscore, and may be followed by letters, digits, or underscores.
     5. Invalid transitions or characters lead to rejection.
     </summary>*/
-    const int identifierTable[5][4] =
+    static constexpr int identifierTable[5][4] =
     {
         // Columns:      L,   D,  _,  O
                         {2,  -1,  1, -1}, // S0: Start -> (L: S2, _: S1, Others: Reject)
@@ -149,7 +222,7 @@ private:
          - Any other character is accepted as part of the number.
     4. The FSM rejects any invalid transitions, marked with `-1`, and only accepts valid number formats when the final state is one of the accepting states (like S2, S4, or S7).
     </summary>*/
-    const int numberTable[8][5] =
+    static constexpr int numberTable[8][5] =
     {
         // Columns:      D,  S,  .,  E,  O
                         {2,  1,  3, -1, -1}, // S0: Start -> (D: S2, Sign: S1, .: S3, Others: Reject)
@@ -183,7 +256,7 @@ private:
        - Once in S1, the FSM rejects any further inputs, as indicated by the `-2` entries in the second row (S1). This means that no further characters are valid after a valid punctuation token is recognized.
     5. The table effectively handles the detection of individual punctuation characters, treating them as valid and rejecting any additional characters after the first valid punctuation.
     </summary>*/
-    const int punctuationTable[2][7] =
+    static constexpr int punctuationTable[2][7] =
     {
         // Columns:      [,  {,  <,  >,  },  ], Other
                         { 1,  1,  1,  1,  1,  1, -1}, // S0: Start -> Transition to states S1-S6 for respective punctuation
@@ -209,7 +282,7 @@ private:
        - The last row (S13) represents final acceptance of operator tokens like `!=`, `< >`, and `=>`, rejecting all further inputs.
     6. The table defines how different operator characters and combinations (e.g., `+`, `++`, `-`, `--`, `&&`, `||`, etc.) are processed by the FSM.
     </summary>*/
-    const int operatorTable[14][13] =
+    static constexpr int operatorTable[14][13] =
     {
         // Columns:    !,  <,  >,  =,  :,  *,  +,  /,  -,  &,  |,  %, Other
                     {  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, -1 }, // S0: Start -> Transition to specific operator states
@@ -227,35 +300,222 @@ private:
                     { -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 13, -1 }, // S12: `%` -> Accept `%`
                     { -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 }  // S13: `!=` , '<>', '=>' -> Reject all further inputs
     };
+
+    /* <summary>
+    These are the accepting states of the four machines as compile-time bitsets: bit `s` is set when state `s` accepts.
+
+    Logic:
+    1. Identifier: S3. Number: S2, S4 and S7. Punctuation: S1. Operator: S5 to S9, S12 and S13.
+    2. All machines have fewer than 32 states, so one `unsigned` holds each set and the final check in `runFSM` is a shift and a mask.
+    </summary>*/
+    static constexpr unsigned identifierAccept = (1u << 3);
+    static constexpr unsigned numberAccept = (1u << 2) | (1u << 4) | (1u << 7);
+    static constexpr unsigned punctuationAccept = (1u << 1);
+    static constexpr unsigned operatorAccept = (1u << 5) | (1u << 6) | (1u << 7) | (1u << 8) | (1u << 9) | (1u << 12) | (1u << 13);
 public:
+    // Input Modes
+    enum class InputMode
+    {
+        Stream,  // std::ifstream + getline, one line at a time
+        Mapped,  // Whole file as one contiguous buffer (memory-mapped, read() fallback for pipes)
+        Parallel // Mapped buffer split at line boundaries, chunks lexed on a thread pool
+    };
+
+    // Scanner Engines
+    enum class ScanEngine
+    {
+        Cascade,  // Try keyword, identifier, number, punctuation and operator in turn, recursing on the leftover characters
+        MergedDFA,    // One product DFA over all token classes, longest match in a single left-to-right pass
+        Specification // Minimized DFA compiled from a lexer specification file (`loadLexerSpec`), longest match
+    };
+
+    // An edit of the source: `length` bytes at `offset` are replaced by `replacement`
+    struct TextEdit
+    {
+        size_t offset = 0;
+        size_t length = 0;
+        std::string_view replacement;
+    };
+
+    // What `relex` changed in the token stream
+    struct RelexResult
+    {
+        bool applied = false;       // false if the edited range lies outside the source or the result would be too large
+        size_t firstToken = 0;      // index of the first token that was re-lexed
+        size_t removedTokens = 0;   // tokens of the old stream that were replaced
+        size_t insertedTokens = 0;  // tokens that replaced them
+        long long offsetShift = 0;  // added to the offsets of all later tokens
+        int lineShift = 0;          // added to the lines of all later tokens
+        int tokenNoShift = 0;       // to add to the token numbers (`symbolTableFile`) of all later tokens
+    };
+
+private:
+    InputMode inputMode = InputMode::Mapped;
+
+    // Parallel mode: worker threads, and the minimum chunk size so small inputs are not split needlessly
+    unsigned threadCount = std::thread::hardware_concurrency();
+    size_t minChunkSize = 1 << 20;
+
+    // Set on the per-chunk instances of the parallel mode: tokens are only recorded, the owner reports them
+    bool deferOutput = false;
+
+    // Report files that are written, and the console log: how much of it, and where to
+    ArtifactSet artifacts;
+    Verbosity verbosity = Verbosity::Verbose;
+    DiagnosticSink* sink = &consoleSink();
+
+    // Binary token hand-off file (off while the name is empty)
+    std::string binaryTokenFileName;
+    bool binaryDeltaOffsets = false;
+    ScanEngine engine = ScanEngine::Cascade;
+
+    // Run statistics (`setMetrics`); `timingToken` is set while a sampled token is classified, and its report lines are timed into `reportNanos` in `reportSpans` spans
+    LexerMetrics metrics;
+    bool metricsEnabled = false;
+    std::string metricsFileName;
+    bool timingToken = false;
+    uint64_t reportNanos = 0;
+    unsigned reportSpans = 0;
+
+    uint64_t* phaseTimer(LexPhase phase) { return metricsEnabled ? metrics.phaseCounter(phase) : nullptr; }
+
+    // The immutable part of the scanner (merged DFA, compiled specification), shared with other instances; see `ScannerDefinition`
+    std::shared_ptr<const ScannerDefinition> definition;
+
+    static void buildMergedDFA(ScannerDefinition& built);
+
+    /* <summary>
+    These are the byte-to-column tables of the four machines. They are computed at compile time by `buildColumnTable` from the column-mapping functions (see their definitions below the class).
+
+    Logic:
+    1. Entry `b` holds the column that `getIdentifierCol`, `getNumberCol`, `getPunctuationCol` or `getOperatorCol` returns for the byte `b`.
+    2. With them, one step of a machine is a column load plus a transition load, with no branches, no `<cctype>` calls and no indirect call.
+    </summary>*/
+    static const std::array<unsigned char, 256> identifierColumns;
+    static const std::array<unsigned char, 256> numberColumns;
+    static const std::array<unsigned char, 256> punctuationColumns;
+    static const std::array<unsigned char, 256> operatorColumns;
+
+    static constexpr std::array<unsigned char, 256> buildColumnTable(int (*getCol)(char));
+
+    /* <summary>
+    This struct remembers the scans of the separate* helpers while `processToken` splits one token into pieces, so each character is scanned a bounded number of times instead of once per piece.
+
+    Logic:
+    1. Every piece left after a keyword, identifier, number or punctuation ends where the token ends, and starts further right than the one before. A backward scan from that end (the last identifier character, the last number character, the trailing run of identifier characters) therefore gives the same position for all of them, clamped to the piece start. A forward scan (the next punctuation character) stays valid until the piece start passes it.
+    2. The positions belong to the pieces that end at `end`. The prefix left by an operator ends elsewhere and starts over with `reset`.
+    </summary>*/
+    struct SplitCache
+    {
+        const char* end = nullptr;
+        const char* identifierEnd = nullptr;
+        const char* numberEnd = nullptr;
+        const char* trailingWord = nullptr;
+        const char* punctuation = nullptr;
+
+        void reset(const char* pieceEnd)
+        {
+            if (end != pieceEnd)
+                *this = { pieceEnd, nullptr, nullptr, nullptr, nullptr };
+        }
+    };
+
+    friend class LexicalBenchmark;
+    friend class SourceGenerator;
+    friend class ScannerGenerator;
+
+public:
+    Lexical();
+    explicit Lexical(std::shared_ptr<const ScannerDefinition> shared);
+
+    static std::shared_ptr<const ScannerDefinition> defaultDefinition();
+    const std::shared_ptr<const ScannerDefinition>& getDefinition() const { return definition; }
+
     // Mapping Functions
-    int getIdentifierCol(char c);
-    int getNumberCol(char c);
-    int getPunctuationCol(char c);
-    int getOperatorCol(char c);
+    static constexpr int getIdentifierCol(char c);
+    static constexpr int getNumberCol(char c);
+    static constexpr int getPunctuationCol(char c);
+    static constexpr int getOperatorCol(char c);
     // Utility Functions
-    void seperateKeywordToken(const std::string& token, std::string& tokenPart, std::string& lastChar);
-    void seperateIdentifierToken(const std::string& token, std::string& tokenPart, std::string& lastChar);
-    void seperateNumToken(const std::string& token, std::string& tokenPart, std::string& lastChar);
-    void seperatePunctuationToken(const std::string& token, std::string& tokenPart, std::string& lastChar);
-    void separateOperatorToken(const std::string& token, std::string& tokenPart, std::string& lastChar);
+    void seperateKeywordToken(std::string_view token, std::string_view& tokenPart, std::string_view& lastChar);
+    void seperateIdentifierToken(std::string_view token, std::string_view& tokenPart, std::string_view& lastChar, SplitCache* cache = nullptr);
+    void seperateNumToken(std::string_view token, std::string_view& tokenPart, std::string_view& lastChar, SplitCache* cache = nullptr);
+    void seperatePunctuationToken(std::string_view token, std::string_view& tokenPart, std::string_view& lastChar, SplitCache* cache = nullptr);
+    void separateOperatorToken(std::string_view token, std::string_view& tokenPart, std::string_view& lastChar, SplitCache* cache = nullptr);
 
     // FSM Function
-    template <size_t NumColumns>
-    int runFSM(const std::string& token, int startState, const int table[][NumColumns], 
-        int numColumns, int (Lexical::*getCol)(char), const std::unordered_map<int, bool>& validStates);
+    template <const auto& Table, const auto& Columns, unsigned AcceptMask>
+    static constexpr int runFSM(std::string_view token);
 
-    int identifierFSM(const std::string& token);
-    int numberFSM(const std::string& token);
-    int punctuationFSM(const std::string& token);
-    int operatorFSM(const std::string& token);
-    bool isKeyword(const std::string& token);
+    int identifierFSM(std::string_view token);
+    int numberFSM(std::string_view token);
+    int punctuationFSM(std::string_view token);
+    int operatorFSM(std::string_view token);
+    static bool isKeyword(std::string_view token);
 
     // Token Processing
+    void setInputMode(InputMode mode);
+    void setThreadCount(unsigned count);
+    void setTextTokenDump(bool enabled);
+    void setArtifact(Artifact artifact, bool enabled);
+    void setVerbosity(Verbosity level);
+    void setDiagnosticSink(DiagnosticSink& target);
+    void setBinaryTokenFile(const std::string& fileName, bool deltaOffsets = false);
+    void setScanEngine(ScanEngine scanEngine);
+    bool loadLexerSpec(const std::string& fileName);
+    void shareInternTable(ConcurrentInternTable* table);
+    void setMetrics(bool enabled, const std::string& jsonFile = "", unsigned sampleEvery = 64);
+    const LexerMetrics& getMetrics() const { return metrics; }
+    bool isDelimiter(char c);
+    void scanBuffer(const char* data, size_t size);
+    void scanParallel(const char* data, size_t size);
     int PerformLexical(const std::string& Input, const std::string& Token, const std::string& Symbol, const std::string& Error);
-    void processToken(const std::string& token, int lineNum);
+    void processToken(std::string_view token, size_t offset, int lineNum);
+    void scanMerged(std::string_view token, size_t offset, int lineNum);
+    void scanSpecified(std::string_view token, size_t offset, int lineNum);
+    void reportToken(TokenKind kind, std::string_view lexeme, size_t offset, int lineNum);
+    void reportToken(TokenKind kind, std::string_view lexeme, size_t offset, int lineNum, uint32_t lexemeHash);
+    const TokenStream& getTokens() const;
+
+    // Incremental Re-lexing
+    void lexText(std::string_view source);
+    RelexResult relex(std::string& source, const TextEdit& edit);
+    void countToken(TokenKind kind, int delta);
+    void resetRun();
 };
 
+// |-------------------------------------------------------------------------------------------------------------|
+// |                                               Construction                                                  |
+// |-------------------------------------------------------------------------------------------------------------|
+
+/* <summary>
+This constructor uses the process-wide default definition (see `defaultDefinition`), so constructing an instance builds no tables and a short-lived instance per input is cheap.
+</summary>*/
+Lexical::Lexical() : definition(defaultDefinition())
+{
+}
+
+/* <summary>
+This constructor uses a definition shared with other instances, e.g. one that `getDefinition` returned after `loadLexerSpec`. An empty pointer means the default definition.
+</summary>*/
+Lexical::Lexical(std::shared_ptr<const ScannerDefinition> shared) : definition(shared ? std::move(shared) : defaultDefinition())
+{
+}
+
+/* <summary>
+This function returns the definition every instance starts with: the merged DFA and no lexer specification. It is built on first use (thread-safe, as a function-local static) and never changes afterwards.
+</summary>*/
+std::shared_ptr<const ScannerDefinition> Lexical::defaultDefinition()
+{
+    static const std::shared_ptr<const ScannerDefinition> shared = []()
+    {
+        auto built = std::make_shared<ScannerDefinition>();
+        buildMergedDFA(*built);
+        return built;
+    }();
+    return shared;
+}
+
 // |-------------------------------------------------------------------------------------------------------------|
 // |                                         Column-mapping functions                                            |
 // |-------------------------------------------------------------------------------------------------------------|
@@ -265,16 +525,16 @@ This function returns the column index for a given character in an identifier to
 
 Logic:
 1. The function takes a single character `c` as input and checks its type to determine the corresponding column index.
-2. If the character is an alphabetic character (`a-z`, `A-Z`), the function returns `0`, indicating the column for letters in the identifier state transition table.
+2. If the character is an ASCII letter (`a-z`, `A-Z`), the function returns `0`, indicating the column for letters in the identifier state transition table.
 3. If the character is a digit (`0-9`), the function returns `1`, indicating the column for digits in the identifier token.
 4. If the character is an underscore (`_`), the function returns `2`, representing the column for the underscore in identifiers.
 5. If the character doesn't match any of the above, the function returns `3`, indicating an invalid character for an identifier token.
 </summary>*/
-int Lexical::getIdentifierCol(char c)
+constexpr int Lexical::getIdentifierCol(char c)
 {
-    if (isalpha(c))
+    if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'))
         return 0;
-    if (isdigit(c))
+    if (c >= '0' && c <= '9')
         return 1;
     if (c == '_')
         return 2;
@@ -292,9 +552,9 @@ Logic:
 5. If the character is either `e` or `E` (indicating scientific notation), the function returns `3`, representing the column for scientific notation.
 6. If the character doesn't match any of the above, the function returns `4`, indicating an invalid or unrecognized character in a number token.
 </summary>*/
-int Lexical::getNumberCol(char c)
+constexpr int Lexical::getNumberCol(char c)
 {
-    if (isdigit(c))
+    if (c >= '0' && c <= '9')
         return 0;
     if (c == '+' || c == '-')
         return 1;
@@ -315,7 +575,7 @@ Logic:
    - Each punctuation character is assigned a unique column index ranging from 0 to 5.
 3. If the character does not match any of the predefined punctuation characters, the function returns `6`, indicating that the character is invalid for punctuation.
 </summary>*/
-int Lexical::getPunctuationCol(char c)
+constexpr int Lexical::getPunctuationCol(char c)
 {
     switch (c)
     {
@@ -346,7 +606,7 @@ Logic:
    - Each operator is assigned a unique column index ranging from 0 to 11.
 3. If the character does not match any of the predefined operators, the function returns `12`, indicating that the character is invalid for an operator.
 </summary>*/
-int Lexical::getOperatorCol(char c)
+constexpr int Lexical::getOperatorCol(char c)
 {
     switch (c)
     {
@@ -381,137 +641,328 @@ int Lexical::getOperatorCol(char c)
 
 
 
+/* <summary>
+This function builds the byte-to-column table of one machine at compile time.
+
+Logic:
+1. For every byte value `b` from 0 to 255, store the column `getCol` returns for the same `char`.
+2. Bytes above 0x7F become negative `char` values; they are no letter, digit or operator character, so every machine maps them to its "Other" column.
+</summary>*/
+constexpr std::array<unsigned char, 256> Lexical::buildColumnTable(int (*getCol)(char))
+{
+    std::array<unsigned char, 256> columns = {};
+    for (int b = 0; b < 256; ++b)
+        columns[b] = static_cast<unsigned char>(getCol(static_cast<char>(b)));
+    return columns;
+}
+
+constexpr std::array<unsigned char, 256> Lexical::identifierColumns = Lexical::buildColumnTable(&Lexical::getIdentifierCol);
+constexpr std::array<unsigned char, 256> Lexical::numberColumns = Lexical::buildColumnTable(&Lexical::getNumberCol);
+constexpr std::array<unsigned char, 256> Lexical::punctuationColumns = Lexical::buildColumnTable(&Lexical::getPunctuationCol);
+constexpr std::array<unsigned char, 256> Lexical::operatorColumns = Lexical::buildColumnTable(&Lexical::getOperatorCol);
+
+
 // |-------------------------------------------------------------------------------------------------------------|
 // |                                         Unified FSM driver function                                         |
 // |-------------------------------------------------------------------------------------------------------------|
 
 /* <summary>
-    This function runs a finite state machine (FSM) on a given token to validate its structure according to a state transition table.
+    This function runs a finite state machine (FSM) on a given token to validate its structure according to a state transition table. It is instantiated once per machine, so the table, its dimensions, the column table and the accepting states are all compile-time constants.
 
     Logic:
-    1. The function takes a template parameter `NumColumns`, which specifies the number of columns in the state transition table.
-    2. Initialize `state` with the `startState` value, which represents the starting point of the FSM.
-    3. Iterate through each character `c` in the token:
-       - Use the `getCol` function to determine the column index for the current character.
-       - If the column index is invalid (i.e., less than 0 or greater than or equal to `numColumns`), return `-1`, indicating an invalid token.
-       - Use the current state and column to find the next state from the `table`.
-       - If the state is `-1`, return `-1`, indicating an invalid state.
-    4. After processing all characters, check if the final state is a valid state by looking it up in the `validStates` map.
-       - If the state is valid, return the final state.
-       - If the state is not valid, return `-1`, indicating an invalid token.
+    1. The template parameters are the transition table `Table`, the byte-to-column table `Columns` and the bitset of accepting states `AcceptMask`. The number of columns is taken from the type of `Table`.
+    2. Start in state 0.
+    3. For each character `c` in the token, read its column from `Columns` and the next state from `Table`.
+       - A negative state means the machine rejected the token, so return `-1` immediately.
+    4. After processing all characters, return the final state if its bit is set in `AcceptMask`, otherwise `-1`.
+    5. Nothing is allocated, and the function can also be evaluated at compile time.
     </summary>*/
-template <size_t NumColumns>
-int Lexical::runFSM(const std::string& token, int startState, const int table[][NumColumns], int numColumns, int (Lexical::*getCol)(char), const std::unordered_map<int, bool>& validStates)
+template <const auto& Table, const auto& Columns, unsigned AcceptMask>
+constexpr int Lexical::runFSM(std::string_view token)
 {
-    int state = startState;
+    using TableType = std::remove_reference_t<decltype(Table)>;
+    static_assert(std::extent_v<TableType, 0> <= 32, "accept bitset holds at most 32 states");
+
+    int state = 0;
     for (char c : token)
     {
-        int col = (this->*getCol)(c);
-        if (col >= numColumns || col < 0)
-            return -1; // Invalid column
-        state = table[state][col];
-        if (state == -1)
+        state = Table[state][Columns[static_cast<unsigned char>(c)]];
+        if (state < 0)
             return -1; // Invalid state
     }
-    return validStates.count(state) ? state : -1;
+    return ((AcceptMask >> state) & 1u) ? state : -1;
 }
 
 // |-------------------------------------------------------------------------------------------------------------|
 // |                                         Wrapper FSM Functions                                               |
 // |-------------------------------------------------------------------------------------------------------------|
 
+// With `LEXICAL_DIRECT_CODED` defined, the wrappers call the direct-coded machines in `directScanner.h` (generated by `Scanner Generator.cpp`) instead of `runFSM`
+
 /* <summary>
-This function checks if a given token is a valid identifier by running a finite state machine (FSM).
+This function checks if a given token is an identifier by running a finite state machine (FSM).
 
 Logic:
-1. Define a map `validStates` that contains the valid final state for identifier tokens. The key `3` represents the valid final state, and the value `true` indicates its validity.
-2. The function calls `runFSM` to validate the identifier token:
-   - Pass the token to the `runFSM` function, starting from the initial state (0).
-   - The function uses the `identifierTable` to define the state transitions, with `4` being the final state.
-   - The `getIdentifierCol` function is used to retrieve the appropriate column index for state transitions.
-   - The `validStates` map is passed to check if the final state is one of the valid states for an identifier.
-3. The return value of `runFSM` is the result of the FSM validation, which will indicate whether the token is a valid identifier or not.
+1. The function calls the `runFSM` instance for this machine: `identifierTable` for the transitions, `identifierColumns` for the byte-to-column mapping and `identifierAccept` for the accepting states (S3).
+2. The return value of `runFSM` is the accepting state reached, or `-1` when the token is not an identifier.
 </summary>*/
-int Lexical::identifierFSM(const std::string& token)
+int Lexical::identifierFSM(std::string_view token)
 {
-    std::unordered_map<int, bool> validStates = { {3, true} };
-    return runFSM(token, 0, identifierTable, 4, &Lexical::getIdentifierCol, validStates);
+#ifdef LEXICAL_DIRECT_CODED
+    return DirectScanner::identifierFSM(token);
+#else
+    return runFSM<identifierTable, identifierColumns, identifierAccept>(token);
+#endif
 }
 
 /* <summary>
-This function checks if a given token is a valid number by running a finite state machine (FSM).
+This function checks if a given token is a number by running a finite state machine (FSM).
 
 Logic:
-1. Define a map `validStates` that contains the valid final states for number tokens. The keys represent valid states (`2`, `4`, `7`), and the values are all set to `true` to indicate validity.
-2. The function calls `runFSM` to validate the number token:
-   - Pass the token to the `runFSM` function, starting from the initial state (0).
-   - The function uses the `numberTable` to define the state transitions, with `6` being the final state.
-   - The `getNumberCol` function is used to retrieve the appropriate column index for state transitions.
-   - The `validStates` map is passed to check if the final state is one of the valid states for a number.
-3. The return value of `runFSM` is the result of the FSM validation, which will indicate whether the token is a valid number or not.
+1. The function calls the `runFSM` instance for this machine: `numberTable` for the transitions, `numberColumns` for the byte-to-column mapping and `numberAccept` for the accepting states (S2, S4 or S7).
+2. The return value of `runFSM` is the accepting state reached, or `-1` when the token is not a number.
 </summary>*/
-int Lexical::numberFSM(const std::string& token)
+int Lexical::numberFSM(std::string_view token)
 {
-    std::unordered_map<int, bool> validStates = { {2, true}, {4, true}, {7, true} };
-    return runFSM(token, 0, numberTable, 6, &Lexical::getNumberCol, validStates);
+#ifdef LEXICAL_DIRECT_CODED
+    return DirectScanner::numberFSM(token);
+#else
+    return runFSM<numberTable, numberColumns, numberAccept>(token);
+#endif
 }
 
 /* <summary>
-This function checks if a given token is a valid punctuation character by running a finite state machine (FSM).
+This function checks if a given token is a punctuation character by running a finite state machine (FSM).
 
 Logic:
-1. Define a map `validStates` that contains the valid final state for punctuation tokens. The key `1` represents the valid final state, and the value `true` indicates its validity.
-2. The function calls `runFSM` to validate the punctuation token:
-   - Pass the token to the `runFSM` function, starting from the initial state (0).
-   - The function uses the `punctuationTable` to define the state transitions, with `7` being the final state.
-   - The `getPunctuationCol` function is used to retrieve the appropriate column index for state transitions.
-   - The `validStates` map is passed to check if the final state is one of the valid states for punctuation.
-3. The return value of `runFSM` is the result of the FSM validation, which will indicate whether the token is a valid punctuation character or not.
+1. The function calls the `runFSM` instance for this machine: `punctuationTable` for the transitions, `punctuationColumns` for the byte-to-column mapping and `punctuationAccept` for the accepting states (S1).
+2. The return value of `runFSM` is the accepting state reached, or `-1` when the token is not a punctuation character.
 </summary>*/
-int Lexical::punctuationFSM(const std::string& token)
+int Lexical::punctuationFSM(std::string_view token)
 {
-    std::unordered_map<int, bool> validStates = { {1, true} };
-    return runFSM(token, 0, punctuationTable, 7, &Lexical::getPunctuationCol, validStates);
+#ifdef LEXICAL_DIRECT_CODED
+    return DirectScanner::punctuationFSM(token);
+#else
+    return runFSM<punctuationTable, punctuationColumns, punctuationAccept>(token);
+#endif
 }
 
 /* <summary>
-This function checks if a given token is a valid operator by running a finite state machine (FSM).
+This function checks if a given token is an operator by running a finite state machine (FSM).
 
 Logic:
-1. Define a map `validStates` that contains the valid final states for operator tokens. These states are represented by integer keys, and the values are all set to `true` to indicate validity.
-2. The function calls `runFSM` to validate the operator token:
-   - Pass the token to the `runFSM` function, starting from the initial state (0).
-   - The function uses the `operatorTable` to define the state transitions, with `13` being the final state.
-   - The `getOperatorCol` function is used to retrieve the appropriate column index for state transitions.
-   - The `validStates` map is passed to check if the final state is one of the valid states for an operator.
-3. The return value of `runFSM` is the result of the FSM validation, which will indicate whether the token is a valid operator or not.
+1. The function calls the `runFSM` instance for this machine: `operatorTable` for the transitions, `operatorColumns` for the byte-to-column mapping and `operatorAccept` for the accepting states (S5 to S9, S12 or S13).
+2. The return value of `runFSM` is the accepting state reached, or `-1` when the token is not an operator.
 </summary>*/
-int Lexical::operatorFSM(const std::string& token)
+int Lexical::operatorFSM(std::string_view token)
 {
-    // Define valid final states for operators
-    std::unordered_map<int, bool> validStates = { {13, true}, {6, true},  {7, true},  {8, true},  {9, true}, {12, true}, {5, true} };
-
-    // Call runFSM to validate the operator token
-    return runFSM(token, 0, operatorTable, 13, &Lexical::getOperatorCol, validStates);
+#ifdef LEXICAL_DIRECT_CODED
+    return DirectScanner::operatorFSM(token);
+#else
+    return runFSM<operatorTable, operatorColumns, operatorAccept>(token);
+#endif
 }
 
 
 
+// |-------------------------------------------------------------------------------------------------------------|
+// |                                               Merged DFA                                                    |
+// |-------------------------------------------------------------------------------------------------------------|
+
+/* <summary>
+This function builds into `built` one DFA that runs the identifier, number, punctuation and operator machines in lock-step (product construction), so a lexeme can be classified in a single left-to-right pass.
+
+Logic:
+1. Partition the 256 byte values into merged character classes:
+   - For every byte, collect its column in each of the four tables from the byte-to-column tables (`identifierColumns`, `numberColumns`, `punctuationColumns`, `operatorColumns`).
+   - Bytes with the same four columns behave identically in every machine and share one class.
+2. Explore the reachable state tuples breadth-first, starting with the tuple of start states `(0, 0, 0, 0)`:
+   - For each class, advance every machine that is still alive using its own table. A rejected machine (`-1`, or `-2` in the punctuation table) stays rejected.
+   - If every machine has rejected, the transition is `-1`. Otherwise the tuple is looked up (or added) and its index is the target state.
+3. For every state record:
+   - The accepted token kind, using the final states of `identifierFSM`, `numberFSM`, `punctuationFSM` and `operatorFSM`, with the cascade's priority when several accept.
+   - Whether the identifier machine is in S2 (a letter followed by letters/digits), which makes the lexeme a keyword candidate.
+</summary>*/
+void Lexical::buildMergedDFA(ScannerDefinition& built)
+{
+    // Step 1: merged character classes
+    std::vector<std::array<int, 4>> classColumns;
+    for (int b = 0; b < 256; ++b)
+    {
+        std::array<int, 4> columns = { identifierColumns[b], numberColumns[b], punctuationColumns[b], operatorColumns[b] };
+
+        size_t cls = 0;
+        while (cls < classColumns.size() && classColumns[cls] != columns)
+            cls++;
+        if (cls == classColumns.size())
+            classColumns.push_back(columns);
+        built.mergedClass[b] = static_cast<unsigned char>(cls);
+    }
+    built.mergedClassCount = static_cast<int>(classColumns.size());
+
+    // Step 2: reachable state tuples (identifier, number, punctuation, operator)
+    std::vector<std::array<int, 4>> states = { { 0, 0, 0, 0 } };
+    std::map<std::array<int, 4>, int> stateIndex = { { states[0], 0 } };
+    built.mergedTransitions.clear();
+
+    for (size_t from = 0; from < states.size(); ++from)
+    {
+        for (int cls = 0; cls < built.mergedClassCount; ++cls)
+        {
+            const std::array<int, 4> current = states[from];
+            const std::array<int, 4>& cols = classColumns[cls];
+            std::array<int, 4> next =
+            {
+                current[0] < 0 ? -1 : identifierTable[current[0]][cols[0]],
+                current[1] < 0 ? -1 : numberTable[current[1]][cols[1]],
+                current[2] < 0 ? -1 : punctuationTable[current[2]][cols[2]],
+                current[3] < 0 ? -1 : operatorTable[current[3]][cols[3]]
+            };
+
+            bool alive = false;
+            for (int& component : next)
+            {
+                if (component < 0)
+                    component = -1;
+                else
+                    alive = true;
+            }
+
+            int target = -1;
+            if (alive)
+            {
+                std::map<std::array<int, 4>, int>::iterator it = stateIndex.find(next);
+                if (it == stateIndex.end())
+                {
+                    target = static_cast<int>(states.size());
+                    stateIndex[next] = target;
+                    states.push_back(next);
+                }
+                else
+                {
+                    target = it->second;
+                }
+            }
+            built.mergedTransitions.push_back(target);
+        }
+    }
+
+    // Step 3: accepted kind and keyword candidates per state
+    built.mergedAccept.assign(states.size(), TokenKind::Invalid);
+    built.mergedKeywordCandidate.assign(states.size(), false);
+    for (size_t i = 0; i < states.size(); ++i)
+    {
+        int id = states[i][0], num = states[i][1], punct = states[i][2], op = states[i][3];
+
+        if (id == 3)
+            built.mergedAccept[i] = TokenKind::Identifier;
+        else if (num == 2 || num == 4 || num == 7)
+            built.mergedAccept[i] = TokenKind::Number;
+        else if (punct == 1)
+            built.mergedAccept[i] = TokenKind::Punctuation;
+        else if (op == 5 || op == 6 || op == 7 || op == 8 || op == 9 || op == 12 || op == 13)
+            built.mergedAccept[i] = TokenKind::Operator;
+
+        built.mergedKeywordCandidate[i] = (id == 2);
+    }
+}
+
 // |-------------------------------------------------------------------------------------------------------------|
 // |                                             Keyword Check                                                   |
 // |-------------------------------------------------------------------------------------------------------------|
 
+/* <summary>
+This function builds the key the keyword hash works on: the token's length in the low byte, then its first, second and last character.
+</summary>*/
+constexpr uint32_t Lexical::keywordKey(std::string_view token)
+{
+    return static_cast<uint32_t>(token.size() & 0xFF)
+        | static_cast<uint32_t>(static_cast<unsigned char>(token[0])) << 8
+        | static_cast<uint32_t>(static_cast<unsigned char>(token[1])) << 16
+        | static_cast<uint32_t>(static_cast<unsigned char>(token[token.size() - 1])) << 24;
+}
+
+/* <summary>
+This function maps a key to a slot of the keyword hash (multiplicative hashing, top `keywordHashBits` bits of the product).
+</summary>*/
+constexpr uint32_t Lexical::keywordSlot(uint32_t key, uint32_t seed)
+{
+    return (key * seed) >> (32 - keywordHashBits);
+}
+
+/* <summary>
+This function generates the perfect hash over `keywords` at compile time.
+
+Logic:
+1. Try odd seeds taken from a fixed linear congruential sequence, so the result is the same on every build.
+2. For each seed, place every keyword in its slot. `owner` remembers which attempt last wrote a slot, so it never has to be cleared between attempts.
+3. The first seed without a collision wins; its slots are filled with the keyword indices plus one.
+4. Keywords must be 2 to `keywordMaxLength` characters long and differ in length, first two or last character. If that is not the case, or no seed is found, the function throws, which stops the compilation.
+</summary>*/
+constexpr Lexical::KeywordHash Lexical::buildKeywordHash()
+{
+    constexpr size_t keywordCount = sizeof(keywords) / sizeof(keywords[0]);
+    constexpr size_t slotCount = size_t(1) << keywordHashBits;
+    static_assert(keywordCount < 255, "slot indices are stored in one byte");
+
+    for (size_t i = 0; i < keywordCount; ++i)
+    {
+        if (keywords[i].size() < 2 || keywords[i].size() > keywordMaxLength)
+            throw "keyword length outside the range supported by the keyword hash";
+        for (size_t j = 0; j < i; ++j)
+        {
+            if (keywordKey(keywords[i]) == keywordKey(keywords[j]))
+                throw "two keywords share length, first two and last character";
+        }
+    }
+
+    uint32_t owner[slotCount] = {};
+    uint32_t candidate = 0x9E3779B9u;
+    for (uint32_t attempt = 1; attempt <= 100000; ++attempt)
+    {
+        uint32_t seed = candidate | 1u;
+        candidate = candidate * 1664525u + 1013904223u;
+
+        bool collision = false;
+        for (size_t i = 0; i < keywordCount && !collision; ++i)
+        {
+            uint32_t slot = keywordSlot(keywordKey(keywords[i]), seed);
+            collision = owner[slot] == attempt;
+            owner[slot] = attempt;
+        }
+        if (collision)
+            continue;
+
+        KeywordHash hash;
+        hash.seed = seed;
+        for (size_t i = 0; i < keywordCount; ++i)
+            hash.slots[keywordSlot(keywordKey(keywords[i]), seed)] = static_cast<unsigned char>(i + 1);
+        return hash;
+    }
+    throw "no perfect hash found for the keyword list";
+}
+
+constexpr Lexical::KeywordHash Lexical::keywordHash = Lexical::buildKeywordHash();
+
 /* <summary>
 This function checks if a given token is a valid keyword.
 
 Logic:
-1. The function checks if the token exists in the `keywords` container (likely a set or map).
-2. If the token is found in the `keywords` container, the function returns `true`, indicating that the token is a valid keyword.
-3. If the token is not found in the `keywords` container, the function returns `false`, indicating that the token is not a keyword.
+1. Tokens shorter than 2 or longer than `keywordMaxLength` characters cannot be keywords.
+2. Otherwise the perfect hash selects the only keyword the token can be. An empty slot means the token is not a keyword.
+3. The token is a keyword if it has the same length and bytes (`memcmp`) as that keyword.
 </summary>*/
-bool Lexical::isKeyword(const std::string& token)
+bool Lexical::isKeyword(std::string_view token)
 {
-    return keywords.find(token) != keywords.end();
+    if (token.size() < 2 || token.size() > keywordMaxLength)
+        return false;
+
+    unsigned char slot = keywordHash.slots[keywordSlot(keywordKey(token), keywordHash.seed)];
+    if (slot == 0)
+        return false;
+
+    std::string_view keyword = keywords[slot - 1];
+    return keyword.size() == token.size() && std::memcmp(keyword.data(), token.data(), token.size()) == 0;
 }
 
 
@@ -529,20 +980,21 @@ Logic:
 1. Initialize `tokenPart` with the entire token and `lastChar` as an empty string.
 2. Check if the last character of the token is a non-alphabetic character:
    - If it is non-alphabetic, separate the token:
-     - Extract the substring excluding the last character and assign it to `tokenPart`.
-     - Assign the last character of the token to `lastChar`.
+     - Take the view excluding the last character as `tokenPart`.
+     - Take the last character of the token as `lastChar`.
    - If the last character is alphabetic, no changes are made to `tokenPart` or `lastChar`.
+3. Both parts are views into `token`; nothing is copied.
 </summary>*/
-void Lexical::seperateKeywordToken(const std::string& token, std::string& tokenPart, std::string& lastChar)
+void Lexical::seperateKeywordToken(std::string_view token, std::string_view& tokenPart, std::string_view& lastChar)
 {
     tokenPart = token;
-    lastChar = "";
+    lastChar = std::string_view();
 
     // Check if the last character is non-alphabetic
     if (!isalpha(token.back()))
     {
-        tokenPart = token.substr(0, token.length() - 1); // Extract all except the last character
-        lastChar = token.back();                          // Store the last character
+        tokenPart = token.substr(0, token.length() - 1); // All except the last character
+        lastChar = token.substr(token.length() - 1);     // The last character
     }
 }
 
@@ -552,38 +1004,44 @@ This function separates a string token into two parts:
 - `lastChar`: Any trailing characters that do not belong to a valid identifier.
 
 Logic:
-1. Initialize `tokenPart` with the entire token and `lastChar` as an empty string.
-2. Traverse the token from the end:
+1. Traverse the token from the end:
    - Start at the last character of the token and move backwards.
    - Check each character to determine if it is part of a valid identifier. Valid identifier characters include:
      - Alphabetic characters (`a-z`, `A-Z`),
      - Digits (`0-9`),
      - The underscore (`_`).
-   - Stop the traversal once a character that does not belong to a valid identifier is found.
-3. Extract the valid identifier portion from the start of the token to the last valid identifier character and assign it to `tokenPart`.
-4. Extract the trailing characters (those that don't belong to the identifier) and assign them to `lastChar`.
+   - Stop the traversal once a character that belongs to a valid identifier is found.
+   - With a `cache` (see `SplitCache`), a position found for an earlier piece with the same end is reused instead.
+2. The view from the start of the token to the last valid identifier character is `tokenPart`.
+3. The trailing characters (those that don't belong to the identifier) are `lastChar`.
 </summary>*/
-void Lexical::seperateIdentifierToken(const std::string& token, std::string& tokenPart, std::string& lastChar)
+void Lexical::seperateIdentifierToken(std::string_view token, std::string_view& tokenPart, std::string_view& lastChar, SplitCache* cache)
 {
-    tokenPart = token;
-    lastChar = "";
+    const char* first = token.data();
+    const char* last = first + token.length();
+    const char* pos;
 
-    // Check for trailing characters that are not part of a valid identifier
-    size_t pos = token.length();
-    while (pos > 0)
+    if (cache && cache->end == last && cache->identifierEnd)
+    {
+        pos = std::max(cache->identifierEnd, first);
+    }
+    else
     {
-        char c = token[pos - 1];
-        // Stop if the character is a digit, an alphabet, or an underscore
-        if (isalnum(c) || c == '_')
+        // Check for trailing characters that are not part of a valid identifier
+        pos = last;
+        while (pos > first && !(isalnum(pos[-1]) || pos[-1] == '_'))
         {
-            break;
+            pos--;
+        }
+        if (cache)
+        {
+            cache->reset(last);
+            cache->identifierEnd = pos;
         }
-        pos--;
     }
 
-    // Extract the valid identifier part and trailing characters
-    tokenPart = token.substr(0, pos);       // Extract the valid identifier part
-    lastChar = token.substr(pos);           // Extract the trailing characters
+    tokenPart = token.substr(0, pos - first);   // The valid identifier part
+    lastChar = token.substr(pos - first);       // The trailing characters
 }
 
 /* <summary>
@@ -592,34 +1050,40 @@ This function separates a numeric token into two parts:
 - `lastChar`: Any trailing characters after the valid number portion.
 
 Logic:
-1. Initialize `tokenPart` with the entire token and `lastChar` as an empty string.
-2. Traverse the token from the end to identify the last valid character that can be part of a number:
+1. Traverse the token from the end to identify the last valid character that can be part of a number:
    - Stop the traversal when encountering a valid numeric character: a digit (`0-9`), a decimal point (`.`), or scientific notation markers (`e/E`).
-   - Decrease the position index (`pos`) for trailing characters that are not valid number parts.
-3. Extract the numeric portion into `tokenPart` using the substring from the start to the last valid position.
-4. Extract the trailing non-numeric characters into `lastChar` from the last valid position to the end of the token.
+   - Decrease the position for trailing characters that are not valid number parts.
+   - With a `cache` (see `SplitCache`), a position found for an earlier piece with the same end is reused instead.
+2. The view from the start to the last valid position is `tokenPart`.
+3. The trailing non-numeric characters from the last valid position to the end of the token are `lastChar`.
 </summary>*/
-void Lexical::seperateNumToken(const std::string& token, std::string& tokenPart, std::string& lastChar)
+void Lexical::seperateNumToken(std::string_view token, std::string_view& tokenPart, std::string_view& lastChar, SplitCache* cache)
 {
-    tokenPart = token;
-    lastChar = "";
+    const char* first = token.data();
+    const char* last = first + token.length();
+    const char* pos;
 
-    // Check for trailing characters that are not part of a valid number
-    size_t pos = token.length();
-    while (pos > 0)
+    if (cache && cache->end == last && cache->numberEnd)
+    {
+        pos = std::max(cache->numberEnd, first);
+    }
+    else
     {
-        char c = token[pos - 1];
-        // Stop if the character is a digit, decimal point, or part of scientific notation (E/e)
-        if (isdigit(c) || c == '.' || c == 'e' || c == 'E')
+        // Check for trailing characters that are not part of a valid number
+        pos = last;
+        while (pos > first && !(isdigit(pos[-1]) || pos[-1] == '.' || pos[-1] == 'e' || pos[-1] == 'E'))
         {
-            break;
+            pos--;
+        }
+        if (cache)
+        {
+            cache->reset(last);
+            cache->numberEnd = pos;
         }
-        pos--;
     }
 
-    // Extract the number part and trailing characters
-    tokenPart = token.substr(0, pos);       // Extract the valid number part
-    lastChar = token.substr(pos);           // Extract the trailing characters
+    tokenPart = token.substr(0, pos - first);   // The valid number part
+    lastChar = token.substr(pos - first);       // The trailing characters
 }
 
 /* <summary>
@@ -628,85 +1092,106 @@ This function processes a string token to separate punctuation characters from t
 - `lastChar`: The part of the token containing the first punctuation character (and any remaining characters).
 
 Logic:
-1. Initialize `tokenPart` and `lastChar` to empty strings.
-2. Iterate through the token, character by character:
-   - If a valid punctuation character (determined by `getPunctuationCol`) is found:
-     a. If `tokenPart` already contains non-punctuation characters, store the remaining string (from the punctuation onward) in `lastChar` and stop.
-     b. Otherwise, set `tokenPart` to the punctuation character, and `lastChar` to the rest of the string after the punctuation, and stop.
-   - If the character is not punctuation, append it to `tokenPart`.
-3. If no punctuation character is encountered, `lastChar` remains empty.
+1. Find the first valid punctuation character (determined by `getPunctuationCol`). With a `cache` (see `SplitCache`), the position found for an earlier piece with the same end is reused while it is not behind the start of the token.
+2. If it is not the first character, `tokenPart` is everything before it and `lastChar` the rest (from the punctuation onward).
+3. Otherwise, `tokenPart` is the punctuation character, and `lastChar` the rest of the string after the punctuation.
+4. If no punctuation character is encountered, `tokenPart` is the whole token and `lastChar` remains empty.
 </summary>*/
-void Lexical::seperatePunctuationToken(const std::string& token, std::string& tokenPart, std::string& lastChar)
+void Lexical::seperatePunctuationToken(std::string_view token, std::string_view& tokenPart, std::string_view& lastChar, SplitCache* cache)
 {
-    tokenPart = "";
-    lastChar = "";
-    size_t pos = 0;
+    const char* first = token.data();
+    const char* last = first + token.length();
+    const char* punctuation;
 
-    // Iterate through the token to separate punctuation
-    while (pos < token.length())
+    if (cache && cache->end == last && cache->punctuation && cache->punctuation >= first)
     {
-        char c = token[pos];
-        if (getPunctuationCol(c) >= 0 && getPunctuationCol(c) <= 5)
+        punctuation = cache->punctuation;
+    }
+    else
+    {
+        // Iterate through the token to find the first punctuation character
+        punctuation = first;
+        while (punctuation < last && !(getPunctuationCol(*punctuation) >= 0 && getPunctuationCol(*punctuation) <= 5))
         {
-            // If valid punctuation is found, terminate tokenPart
-            if (!tokenPart.empty())
-            {
-                // Store the current tokenPart in lastChar and stop
-                lastChar = token.substr(pos);  // Remaining characters (punctuation and beyond)
-                return;
-            }
-
-            // Add the punctuation as the tokenPart and stop
-            tokenPart = std::string(1, c);
-            lastChar = token.substr(pos + 1);  // Remaining characters after the punctuation
-            return;
+            punctuation++;
         }
-        else
+        if (cache)
         {
-            // Add the character to tokenPart
-            tokenPart += c;
+            cache->reset(last);
+            cache->punctuation = punctuation;
         }
-        pos++;
     }
 
-    // If no punctuation is found, lastChar remains empty
+    size_t pos = punctuation - first;
+    if (pos == token.length())
+    {
+        // If no punctuation is found, lastChar remains empty
+        tokenPart = token;
+        lastChar = std::string_view();
+    }
+    else if (pos > 0)
+    {
+        // Characters before the punctuation end tokenPart; the rest goes to lastChar
+        tokenPart = token.substr(0, pos);
+        lastChar = token.substr(pos);
+    }
+    else
+    {
+        // The punctuation itself is the tokenPart
+        tokenPart = token.substr(0, 1);
+        lastChar = token.substr(1);
+    }
 }
 
 /* <summary>
 This function processes a string token to separate it into two parts:
 - `tokenPart`: The central portion of the token that excludes any valid characters (letters, digits, or underscores) at the beginning or end of the token.
-- `lastChar`: The valid characters found at the beginning and end of the token, concatenated together.
+- `lastChar`: The valid characters found at the beginning or end of the token.
 
 Logic:
 1. The function first clears `tokenPart` and `lastChar`.
 2. It scans the token from the start to identify valid characters (alphanumeric or underscores).
    - These characters, if found, set the `hasStartValid` flag to true and increment the starting index.
-3. Similarly, it scans the token from the end for valid characters, setting the `hasEndValid` flag to true if any are found.
+3. Similarly, it scans the token from the end for valid characters, setting the `hasEndValid` flag to true if any are found. With a `cache` (see `SplitCache`), the start of the trailing run found for an earlier piece with the same end is reused.
 4. If valid characters are found at both the start and end, the entire token is treated as `tokenPart`, and `lastChar` remains empty.
-5. If only a portion of the token is valid at the start or end, these valid characters are extracted into `lastChar`, while the remaining part is assigned to `tokenPart`.
+5. Otherwise the valid characters are only at one end, so `lastChar` is a single view: the leading run (a prefix of the token) or the trailing run (a suffix). The remaining part is `tokenPart`.
 </summary>*/
-void Lexical::separateOperatorToken(const std::string& token, std::string& tokenPart, std::string& lastChar)
+void Lexical::separateOperatorToken(std::string_view token, std::string_view& tokenPart, std::string_view& lastChar, SplitCache* cache)
 {
-    tokenPart = "";
-    lastChar = "";
-
-    size_t start = 0;
-    size_t end = token.length();
+    tokenPart = std::string_view();
+    lastChar = std::string_view();
 
-    // Check if the token has valid characters at both ends
-    bool hasStartValid = false, hasEndValid = false;
+    const char* first = token.data();
+    const char* last = first + token.length();
+    const char* start = first;
+    const char* end;
 
-    while (start < end && (isalnum(token[start]) || token[start] == '_'))
+    while (start < last && (isalnum(*start) || *start == '_'))
     {
-        hasStartValid = true;
         start++;
     }
 
-    while (end > start && (isalnum(token[end - 1]) || token[end - 1] == '_'))
+    if (cache && cache->end == last && cache->trailingWord)
     {
-        hasEndValid = true;
-        end--;
+        end = std::max(cache->trailingWord, start);
     }
+    else
+    {
+        end = last;
+        while (end > start && (isalnum(end[-1]) || end[-1] == '_'))
+        {
+            end--;
+        }
+        if (cache)
+        {
+            cache->reset(last);
+            cache->trailingWord = end;
+        }
+    }
+
+    // Check if the token has valid characters at both ends
+    bool hasStartValid = start != first;
+    bool hasEndValid = end != last;
 
     // If both start and end are valid, treat the whole token as tokenPart
     if (hasStartValid && hasEndValid)
@@ -716,8 +1201,8 @@ void Lexical::separateOperatorToken(const std::string& token, std::string& token
     }
 
     // Separate valid characters into lastChar and remaining into tokenPart
-    lastChar = token.substr(0, start) + token.substr(end);
-    tokenPart = token.substr(start, end - start);
+    lastChar = hasStartValid ? token.substr(0, start - first) : token.substr(end - first);
+    tokenPart = token.substr(start - first, end - start);
 }
 
 
@@ -726,101 +1211,427 @@ void Lexical::separateOperatorToken(const std::string& token, std::string& token
 // |-------------------------------------------------------------------------------------------------------------|
 
 /* <summary>
-This is the main function that performs lexical analysis on the content of a file. It reads the file line by line, processes tokens, and outputs results to both the console and output files.
+This function selects how `PerformLexical` reads its input file.
+
+Logic:
+1. `InputMode::Mapped` (the default) exposes the whole file as one contiguous buffer through `SourceBuffer` and scans it with `scanBuffer`.
+2. `InputMode::Stream` keeps the original `std::ifstream` + `getline` loop.
+3. `InputMode::Parallel` maps the file like `InputMode::Mapped` and lexes it in chunks on several threads with `scanParallel`.
+4. All modes produce exactly the same tokens, line numbers and output files.
+</summary>*/
+void Lexical::setInputMode(InputMode mode)
+{
+    inputMode = mode;
+}
+
+/* <summary>
+This function sets the number of worker threads used by `InputMode::Parallel`. The default is the number of hardware threads; 0 is treated as 1.
+</summary>*/
+void Lexical::setThreadCount(unsigned count)
+{
+    threadCount = count;
+}
+
+/* <summary>
+This function turns the human-readable token file (the `Token` argument of `PerformLexical`) on or off. It is on by default; with it off, the file is neither created nor written.
+</summary>*/
+void Lexical::setTextTokenDump(bool enabled)
+{
+    artifacts.set(Artifact::TokenFile, enabled);
+}
+
+/* <summary>
+This function turns one report file of `PerformLexical` on or off: `Artifact::TokenFile`, `Artifact::SymbolTable` or `Artifact::ErrorFile` (the other artifacts belong to the parser). All are on by default; a disabled file is neither created nor written, and its formatting is skipped.
+</summary>*/
+void Lexical::setArtifact(Artifact artifact, bool enabled)
+{
+    artifacts.set(artifact, enabled);
+}
+
+/* <summary>
+This function sets how much `PerformLexical` logs to the diagnostic sink.
 
 Logic:
-1. Open the input file (`test_code.txt`) and check for errors. If the file cannot be opened, output an error message and exit.
+1. `Verbosity::Verbose` (the default) logs every token ("<Type>: <lexeme> at line <n>") and every invalid lexeme, followed by the closing "Lexical analysis done" line.
+2. `Verbosity::Summary` logs only the closing line.
+3. `Verbosity::Quiet` logs nothing. Errors that stop the run are still reported on `std::cerr`.
+</summary>*/
+void Lexical::setVerbosity(Verbosity level)
+{
+    verbosity = level;
+}
+
+/* <summary>
+This function redirects the log of `PerformLexical` from `std::cout` to another sink. The sink must outlive the runs that use it.
+</summary>*/
+void Lexical::setDiagnosticSink(DiagnosticSink& target)
+{
+    sink = &target;
+}
+
+/* <summary>
+This function makes `PerformLexical` also write the tokens of the run as a binary token file (see `BinaryTokenFile`), which the parser can map directly. An empty file name turns it off again. With `deltaOffsets`, source offsets are stored as varint differences instead of 32-bit values.
+</summary>*/
+void Lexical::setBinaryTokenFile(const std::string& fileName, bool deltaOffsets)
+{
+    binaryTokenFileName = fileName;
+    binaryDeltaOffsets = deltaOffsets;
+}
+
+/* <summary>
+This function selects how tokens are classified.
+
+Logic:
+1. `ScanEngine::Cascade` (the default) is the original keyword/identifier/number/punctuation/operator cascade in `processToken`, which defines the reference output.
+2. `ScanEngine::MergedDFA` classifies every lexeme with the merged DFA in `scanMerged`, examining each byte once with longest-match semantics.
+3. `ScanEngine::Specification` classifies every lexeme with the DFA of the loaded lexer specification in `scanSpecified`. It can only be selected after `loadLexerSpec` succeeded; otherwise an error is printed and the engine stays unchanged.
+</summary>*/
+void Lexical::setScanEngine(ScanEngine scanEngine)
+{
+    if (scanEngine == ScanEngine::Specification && !definition->specDFA)
+    {
+        std::cerr << "Error: no lexer specification loaded.\n";
+        return;
+    }
+    engine = scanEngine;
+}
+
+/* <summary>
+This function reads a lexer specification (see `LexerSpec` for the format) and compiles it into the minimized DFA that `ScanEngine::Specification` scans with. It returns `false` and keeps the previous specification if the file cannot be read or has errors. Adding rules to the specification adds states to the DFA but no work per byte.
+The instance then gets a new definition: a copy of its current one with the new DFA. Other instances that shared the old definition keep it unchanged, and `getDefinition` hands the new one to further instances, so a specification is compiled once per process rather than once per instance.
+</summary>*/
+bool Lexical::loadLexerSpec(const std::string& fileName)
+{
+    LexerSpec spec;
+    auto dfa = std::make_shared<LexerDFA>();
+    if (!spec.load(fileName) || !spec.compile(*dfa))
+        return false;
+    auto next = std::make_shared<ScannerDefinition>(*definition);
+    next->specDFA = std::move(dfa);
+    definition = std::move(next);
+    return true;
+}
+
+/* <summary>
+This function makes the token stream of this instance intern its lexemes into `table`, a `ConcurrentInternTable` that other instances on other threads may use at the same time (`nullptr` gives the instance its own table back). Lexers of many files then store every common identifier and keyword once, and equal lexemes get equal ids across all of them; the ids are in order of first insertion by any thread, so they can differ between runs. The per-chunk instances of `scanParallel` use the table as well. The table must outlive the runs, and the current tokens are dropped.
+</summary>*/
+void Lexical::shareInternTable(ConcurrentInternTable* table)
+{
+    tokens.shareLexemes(table);
+    relexTokens.shareLexemes(table);
+}
+
+/* <summary>
+This function turns the run statistics on or off (see `LexerMetrics`). While they are on, `PerformLexical` and `lexText` collect them for every run, and `getMetrics` returns those of the last run; `PerformLexical` also writes them as JSON to `jsonFile` unless it is empty. One token in `sampleEvery` is timed on its own. The per-chunk instances of `InputMode::Parallel` are not sampled, so there `Scan` includes the classification and the report lines.
+</summary>*/
+void Lexical::setMetrics(bool enabled, const std::string& jsonFile, unsigned sampleEvery)
+{
+    metricsEnabled = enabled;
+    metricsFileName = enabled ? jsonFile : std::string();
+    metrics.setSampleInterval(sampleEvery);
+}
+
+/* <summary>
+This function tells whether a character ends the current token. Tokens are separated by whitespace and by the characters `$`, `,`, `;`, `(` and `)`, none of which are part of any token.
+</summary>*/
+bool Lexical::isDelimiter(char c)
+{
+    return isspace(c) || c == '$' || c == ',' || c == ';' || c == '(' || c == ')';
+}
+
+/* <summary>
+This function scans a complete source held in one contiguous buffer and hands every token to `processToken`.
+
+Logic:
+1. Start at line 1 and alternate between two bulk searches of `DelimiterScan` (SSE2/AVX2 when the CPU has them, 16 or 32 bytes per step):
+   - `skipDelimiters` jumps over a run of delimiters (see `isDelimiter`). The newlines in the skipped run advance the line counter, exactly like the line boundaries of `getline` in the stream mode.
+   - `findDelimiter` jumps to the end of the token that starts there.
+2. The token is handed to `processToken` in one piece, as a view into the buffer, together with its offset in the buffer. Only its start and end positions are needed, so no per-character work and no copy happens in this loop.
+3. A token still open at the end of the buffer ends there and is processed as well.
+</summary>*/
+void Lexical::scanBuffer(const char* data, size_t size)
+{
+    int lineNum = 1;
+    size_t i = 0;
+
+    while (i < size)
+    {
+        size_t tokenStart = DelimiterScan::skipDelimiters(data, i, size);
+        lineNum += static_cast<int>(std::count(data + i, data + tokenStart, '\n'));
+        if (tokenStart == size)
+            break;
+
+        size_t tokenEnd = DelimiterScan::findDelimiter(data, tokenStart, size);
+        processToken(std::string_view(data + tokenStart, tokenEnd - tokenStart), tokenStart, lineNum);
+        i = tokenEnd;
+    }
+}
+
+/* <summary>
+This function lexes a buffer in chunks on a thread pool and reports the tokens exactly as `scanBuffer` would on the whole buffer.
+
+Logic:
+1. With a single worker thread there is nothing to overlap, so fall back to `scanBuffer`.
+2. Split the buffer into about four chunks per thread, each at least `minChunkSize` bytes. A chunk always ends right after a newline (or at the end of the buffer), and no token spans a newline, so every token lies in exactly one chunk. With fewer than two chunks, fall back to `scanBuffer` as well.
+3. Give every chunk its own `Lexical` instance with `deferOutput` set and the same scan engine, and run `scanBuffer` on the chunk on the pool. In that mode `reportToken` only appends to the instance's token stream: no counting, no output, no shared state. The task also counts the chunk's newlines and, unless its tokens are replayed (step 5), its token classes (`countToken`).
+4. Back on the calling thread, wait for the chunks in order. Without console output and text reports (token file, symbol table, error file), the tokens need no per-token work here: add the chunk's counters to this instance's and append its stream with `TokenStream::splice`, with offsets shifted by the chunk start and lines shifted by the newlines of all earlier chunks. `splice` interns each distinct lexeme of the chunk once and remaps the ids of its tokens; with a shared intern table (`shareInternTable`) the chunks intern into it directly and their ids are copied.
+5. With console output or a text report enabled, replay each chunk's tokens through `reportToken` instead, with the same shifts. The lexeme hashes the chunk's intern table already holds are passed along, so the replay does not hash the texts again.
+6. Either way, counters, token numbers, console output, output files and the token stream are produced in the same order and with the same values as in a sequential run. Chunks still being lexed overlap with the merge of earlier ones, and a chunk's tokens are released once merged.
+</summary>*/
+void Lexical::scanParallel(const char* data, size_t size)
+{
+    unsigned workerCount = threadCount == 0 ? 1 : threadCount;
+    if (workerCount <= 1)
+    {
+        scanBuffer(data, size);
+        return;
+    }
+    size_t chunkSize = std::max(minChunkSize, size / (size_t(workerCount) * 4) + 1);
+
+    std::vector<size_t> bounds = { 0 };
+    while (bounds.back() < size)
+    {
+        size_t end = bounds.back() + chunkSize;
+        if (end >= size)
+        {
+            end = size;
+        }
+        else
+        {
+            const void* newline = std::memchr(data + end, '\n', size - end);
+            end = newline ? static_cast<size_t>(static_cast<const char*>(newline) - data) + 1 : size;
+        }
+        bounds.push_back(end);
+    }
+
+    const size_t chunkCount = bounds.size() - 1;
+    if (chunkCount < 2)
+    {
+        scanBuffer(data, size);
+        return;
+    }
+
+    const bool replay = console.is_open() || tokenFile.is_open() || symbolTableFile.is_open() || errorFile.is_open();
+    std::vector<Lexical> chunks(chunkCount);
+    std::vector<int> chunkLines(chunkCount, 0);
+    std::vector<std::future<void>> done;
+    done.reserve(chunkCount);
+
+    ThreadPool pool(workerCount);
+    for (size_t c = 0; c < chunkCount; ++c)
+    {
+        done.push_back(pool.submit([this, &chunks, &chunkLines, &bounds, data, c, replay]()
+        {
+            const char* begin = data + bounds[c];
+            const char* end = data + bounds[c + 1];
+            chunks[c].engine = engine;
+            chunks[c].definition = definition;
+            chunks[c].deferOutput = true;
+            chunks[c].shareInternTable(tokens.sharedLexemes());
+            chunks[c].scanBuffer(begin, end - begin);
+            chunkLines[c] = static_cast<int>(std::count(begin, end, '\n'));
+            if (!replay)
+            {
+                for (size_t i = 0; i < chunks[c].tokens.size(); ++i)
+                    chunks[c].countToken(chunks[c].tokens.kind(i), 1);
+            }
+        }));
+    }
+
+    int lineBase = 0;
+    for (size_t c = 0; c < chunkCount; ++c)
+    {
+        done[c].get();
+        const Lexical& chunk = chunks[c];
+        const TokenStream& chunkTokens = chunk.tokens;
+        if (replay)
+        {
+            for (size_t i = 0; i < chunkTokens.size(); ++i)
+            {
+                uint32_t lexemeId = chunkTokens.id(i);
+                reportToken(chunkTokens.kind(i), chunkTokens.text(lexemeId),
+                    bounds[c] + chunkTokens.offset(i), lineBase + static_cast<int>(chunkTokens.line(i)), chunkTokens.hash(lexemeId));
+            }
+        }
+        else
+        {
+            tokens.splice(tokens.size(), tokens.size(), chunkTokens, bounds[c], lineBase);
+            nKeywords += chunk.nKeywords;
+            nIdentifiers += chunk.nIdentifiers;
+            nNumbers += chunk.nNumbers;
+            nPunctuations += chunk.nPunctuations;
+            nOperators += chunk.nOperators;
+            nInvalid += chunk.nInvalid;
+            tokenNo += chunk.tokenNo;
+        }
+        lineBase += chunkLines[c];
+        chunks[c].tokens.clear();
+    }
+}
+
+/* <summary>
+This is the main function that performs lexical analysis on the content of a file. It reads the file (line by line or as one mapped buffer, see `setInputMode`), processes tokens, and outputs results to both the console and output files.
+
+Logic:
+1. Open the input file (`test_code.txt`) and check for errors. If the file cannot be opened, output an error message and exit. An input larger than `TokenStream::maxSourceSize` (4 GiB) is rejected the same way, since its offsets would not fit into the token stream.
+   - In `InputMode::Mapped` and `InputMode::Parallel` the file is opened through `SourceBuffer`, otherwise through `std::ifstream`.
 2. Open two additional output files (`tokenFile` for valid tokens, 'SymbolTable' for symbol table, and `errorFile` for invalid tokens) and check for errors.
 3. Initialize `lineNum` to keep track of the current line number as the file is processed.
 4. For each line in the input file:
    - Increment the `lineNum`.
    - Iterate through each character in the line.
-   - Collect characters into a `token` until a space or special character is encountered, indicating the end of a token.
-   - Process the token using the `processToken` function and clear the `token` buffer.
+   - Collect characters into a token (a view into the line) until a space or special character is encountered, indicating the end of a token.
+   - Process the token using the `processToken` function.
+   In `InputMode::Mapped` the whole buffer is handed to `scanBuffer`, which applies the same rules without copying lines; `InputMode::Parallel` hands it to `scanParallel`.
 5. After processing the line, if there is any remaining token, process it as well.
+   Every token is passed on with its offset in the source, and every reported token is also appended to the in-memory token stream (see `getTokens`), which is cleared, like the counters, at the start of the run (`resetRun`), so an instance can be reused for any number of inputs.
 6. Once all lines are processed:
    - Output the counts of different token types (Keywords, Identifiers, Numbers, Punctuations, Operators, and Invalid tokens) to the console and to the `tokenFile` and `errorFile`.
    - Output a summary of the total token count and the invalid tokens in the `errorFile`.
-7. Close all files (`inputFile`, `tokenFile`, and `errorFile`) after processing is complete.
+7. Close all files (`inputFile`, `tokenFile`, `symbolTableFile` and `errorFile`) after processing is complete. The reports and the console log are buffered by `ReportWriter`, so closing them also writes out what is still buffered.
+   If a binary token file is configured (`setBinaryTokenFile`), write the token stream to it. Each report file is only opened and written while its artifact is enabled (`setArtifact`, `setTextTokenDump`).
 8. Output a message indicating that the lexical analysis is done and results are saved to the `tokenFile` and `errorFile`.
+   The console log goes to the diagnostic sink (`setDiagnosticSink`, `std::cout` by default): the per-token lines only at `Verbosity::Verbose`, this closing line at `Verbosity::Summary` and above (`setVerbosity`).
 </summary>*/
 int Lexical::PerformLexical(const std::string& Input, const std::string& Token, const std::string& Symbol, const std::string& Error)
 {
+    if (metricsEnabled)
+        metrics.begin();
+    LexerMetrics::Stopwatch readTime(phaseTimer(LexPhase::Read));
+
     // Input File
-    std::ifstream inputFile(Input);
+    std::ifstream inputFile;
+    SourceBuffer inputBuffer;
+    bool inputOpened;
+    if (inputMode == InputMode::Mapped || inputMode == InputMode::Parallel)
+    {
+        inputOpened = inputBuffer.open(Input);
+    }
+    else
+    {
+        inputFile.open(Input);
+        inputOpened = inputFile.is_open();
+    }
+    readTime.stop();
     // Files to be created
-    tokenFile.open(Token);
-    symbolTableFile.open(Symbol);
-    errorFile.open(Error);
-
-    if (!inputFile.is_open())
+    if (artifacts.enabled(Artifact::TokenFile))
+        tokenFile.open(Token);
+    if (artifacts.enabled(Artifact::SymbolTable))
+        symbolTableFile.open(Symbol);
+    if (artifacts.enabled(Artifact::ErrorFile))
+        errorFile.open(Error);
+    if (verbosity == Verbosity::Verbose)
+        console.attach(*sink);
+
+    if (!inputOpened)
     {
         std::cerr << "Error opening input file.\n";
         return 1;
     }
-    if (!tokenFile.is_open())
+    // Offsets in the token stream are 32-bit; a larger input would wrap them
+    unsigned long long inputSize = inputBuffer.size();
+    if (inputMode != InputMode::Mapped && inputMode != InputMode::Parallel)
+    {
+        inputFile.seekg(0, std::ios::end);
+        std::streamoff fileSize = inputFile.tellg();
+        inputFile.seekg(0, std::ios::beg);
+        inputSize = fileSize > 0 ? static_cast<unsigned long long>(fileSize) : 0;
+    }
+    if (inputSize > TokenStream::maxSourceSize)
+    {
+        std::cerr << "Error: Input file is larger than 4 GiB, the largest source the token stream can address.\n";
+        return 1;
+    }
+    if (artifacts.enabled(Artifact::TokenFile) && !tokenFile.is_open())
     {
         std::cerr << "Error opening token file.\n";
         return 1;
     }
-    if (!symbolTableFile.is_open())
+    if (artifacts.enabled(Artifact::SymbolTable) && !symbolTableFile.is_open())
     {
         std::cerr << "Error opening Symbol Table file.\n";
         return 1;
     }
-    if (!errorFile.is_open())
+    if (artifacts.enabled(Artifact::ErrorFile) && !errorFile.is_open())
     {
         std::cerr << "Error opening Error file.\n";
         return 1;
     }
 
+    resetRun();
+
     // Write headers for tokenFile
-    tokenFile << std::left
-        << std::setw(colWidthToken) << "Token Value"
-        << std::setw(colWidthType) << "Token Type"
-        << "\n";
-    tokenFile << std::string(colWidthToken + colWidthType, '-') << "\n";
+    if (tokenFile.is_open())
+    {
+        tokenFile.column("Token Value", colWidthToken)
+            .column("Token Type", colWidthType)
+            .text("\n");
+        tokenFile.fill('-', colWidthToken + colWidthType).text("\n");
+    }
 
     // Write headers for symbolTableFile
-    symbolTableFile << std::left
-        << std::setw(colWidthToken) << "Token Value"
-        << std::setw(colWidthType) << "Token Type"
-        << std::setw(colWidthLine) << "Line No"
-        << std::setw(colWidthTokenNo) << "Token No"
-        << "\n";
-    symbolTableFile << std::string(colWidthToken + colWidthType + colWidthLine + colWidthTokenNo, '-') << "\n";
-
-    std::string line;
-    int lineNum = 0;
-
-    while (getline(inputFile, line))
+    symbolTableFile.column("Token Value", colWidthToken)
+        .column("Token Type", colWidthType)
+        .column("Line No", colWidthLine)
+        .column("Token No", colWidthTokenNo)
+        .text("\n");
+    symbolTableFile.fill('-', colWidthToken + colWidthType + colWidthLine + colWidthTokenNo).text("\n");
+
+    LexerMetrics::Stopwatch scanTime(phaseTimer(LexPhase::Scan));
+    size_t inputBytes = inputBuffer.size();
+    if (inputMode == InputMode::Mapped)
+    {
+        scanBuffer(inputBuffer.data(), inputBuffer.size());
+    }
+    else if (inputMode == InputMode::Parallel)
+    {
+        scanParallel(inputBuffer.data(), inputBuffer.size());
+    }
+    else
     {
-        lineNum++;
-        std::string token;
+        std::string line;
+        int lineNum = 0;
+        size_t lineOffset = 0;
 
-        for (size_t i = 0; i < line.length(); ++i)
+        while (getline(inputFile, line))
         {
-            char c = line[i];
+            lineNum++;
+            std::string_view text = line;
+            size_t tokenStart = 0;
+            bool inToken = false;
 
-            // Handle space or special characters (tokens are separated by spaces or special chars)
-            if (isspace(c) || c == '$' || c == ',' || c == ';' || c == '(' || c == ')')
+            for (size_t i = 0; i < text.length(); ++i)
             {
-                if (!token.empty())
+                char c = text[i];
+
+                // Handle space or special characters (tokens are separated by spaces or special chars)
+                if (isDelimiter(c))
                 {
-                    processToken(token, lineNum);
-                    token.clear();
+                    if (inToken)
+                    {
+                        processToken(text.substr(tokenStart, i - tokenStart), lineOffset + tokenStart, lineNum);
+                        inToken = false;
+                    }
+                    continue;
                 }
-                continue;
-            }
 
-            token += c;
-        }
+                if (!inToken)
+                {
+                    tokenStart = i;
+                    inToken = true;
+                }
+            }
 
-        if (!token.empty())
-        {
-            processToken(token, lineNum);
+            if (inToken)
+            {
+                processToken(text.substr(tokenStart), lineOffset + tokenStart, lineNum);
+            }
+            lineOffset += line.length() + 1;
         }
+        inputBytes = lineOffset;
     }
+    scanTime.stop();
+    LexerMetrics::Stopwatch writeTime(phaseTimer(LexPhase::Write));
     //// Console Output
     //std::cout << "\n\n|+++++++++++++++++++++++++++++++++|\n";
     //std::cout << "|\tToken Count               |\n";
@@ -856,43 +1667,64 @@ int Lexical::PerformLexical(const std::string& Input, const std::string& Token,
         << std::setw(colWidthToken + 10) << (nKeywords + nIdentifiers + nNumbers + nPunctuations + nOperators) << "\n";*/
 
     // File Output to Symbol Table
-    symbolTableFile << "\n\n"
-        << std::string(40, '+') << "\n"
-        << "|         Token Count Summary         |\n"
-        << std::string(40, '+') << "\n";
-
-    symbolTableFile << std::left
-        << std::setw(colWidthToken + 10) << "Keywords:"
-        << std::setw(colWidthToken + 10) << nKeywords << "\n"
-        << std::setw(colWidthToken + 10) << "Identifiers:"
-        << std::setw(colWidthToken + 10) << nIdentifiers << "\n"
-        << std::setw(colWidthToken + 10) << "Numbers:"
-        << std::setw(colWidthToken + 10) << nNumbers << "\n"
-        << std::setw(colWidthToken + 10) << "Punctuations:"
-        << std::setw(colWidthToken + 10) << nPunctuations << "\n"
-        << std::setw(colWidthToken + 10) << "Operators:"
-        << std::setw(colWidthToken + 10) << nOperators << "\n"
-        << std::setw(colWidthToken + 10) << "Invalid:"
-        << std::setw(colWidthToken + 10) << nInvalid << "\n"
-        << std::setw(colWidthToken + 10) << "Total Tokens (Valid):"
-        << std::setw(colWidthToken + 10) << (nKeywords + nIdentifiers + nNumbers + nPunctuations + nOperators) << "\n";
+    symbolTableFile.text("\n\n")
+        .fill('+', 40).text("\n")
+        .text("|         Token Count Summary         |\n")
+        .fill('+', 40).text("\n");
+
+    symbolTableFile.column("Keywords:", colWidthToken + 10)
+        .column(nKeywords, colWidthToken + 10).text("\n")
+        .column("Identifiers:", colWidthToken + 10)
+        .column(nIdentifiers, colWidthToken + 10).text("\n")
+        .column("Numbers:", colWidthToken + 10)
+        .column(nNumbers, colWidthToken + 10).text("\n")
+        .column("Punctuations:", colWidthToken + 10)
+        .column(nPunctuations, colWidthToken + 10).text("\n")
+        .column("Operators:", colWidthToken + 10)
+        .column(nOperators, colWidthToken + 10).text("\n")
+        .column("Invalid:", colWidthToken + 10)
+        .column(nInvalid, colWidthToken + 10).text("\n")
+        .column("Total Tokens (Valid):", colWidthToken + 10)
+        .column(nKeywords + nIdentifiers + nNumbers + nPunctuations + nOperators, colWidthToken + 10).text("\n");
 
     // File Output to Error
-    errorFile << "\n\n"
-        << std::string(35, '+') << "\n"
-        << "|       Token Error Summary         |\n"
-        << std::string(35, '+') << "\n";
+    errorFile.text("\n\n")
+        .fill('+', 35).text("\n")
+        .text("|       Token Error Summary         |\n")
+        .fill('+', 35).text("\n");
 
-    errorFile << std::left
-        << std::setw(colWidthToken + 10) << "Invalid:"
-        << std::setw(colWidthToken + 10) << nInvalid << "\n"
-        << std::setw(colWidthToken + 10) << "Total Tokens (including Invalid) :"
-        << std::setw(colWidthToken + 10) << (nKeywords + nIdentifiers + nNumbers + nPunctuations + nOperators + nInvalid) << "\n";
+    errorFile.column("Invalid:", colWidthToken + 10)
+        .column(nInvalid, colWidthToken + 10).text("\n")
+        .column("Total Tokens (including Invalid) :", colWidthToken + 10)
+        .column(nKeywords + nIdentifiers + nNumbers + nPunctuations + nOperators + nInvalid, colWidthToken + 10).text("\n");
 
     inputFile.close();
+    inputBuffer.close();
     tokenFile.close();
+    symbolTableFile.close();
     errorFile.close();
-    std::cout << "Lexical analysis done. See Output in " << Token << ", "<< Symbol << " and "<< Error << " file\n";
+    console.close();
+
+    if (!binaryTokenFileName.empty() && !BinaryTokenFile::write(binaryTokenFileName, tokens, binaryDeltaOffsets))
+    {
+        std::cerr << "Error writing binary token file.\n";
+        return 1;
+    }
+    writeTime.stop();
+    if (metricsEnabled)
+    {
+        metrics.finish(tokens, inputBytes);
+        if (!metricsFileName.empty() && !metrics.writeJson(metricsFileName))
+        {
+            std::cerr << "Error writing metrics file.\n";
+            return 1;
+        }
+    }
+    if (verbosity != Verbosity::Quiet)
+    {
+        sink->write("Lexical analysis done. See Output in " + Token + ", " + Symbol + " and " + Error + " file\n");
+        sink->flush();
+    }
     return 0;
 }
 
@@ -907,177 +1739,509 @@ This function processes a given token to classify it into one of several categor
 
 Logic:
 1. If the token is empty, log "No Tokens" and return.
-2. Initialize a flag `isProcessed` to `false`, which will track if the token has been successfully classified.
-3. Attempt to classify the token into various categories in the following order:
+2. If the merged DFA engine is selected (`ScanEngine::MergedDFA`), hand the token to `scanMerged` and return; likewise hand it to `scanSpecified` for `ScanEngine::Specification`.
+3. Start with the whole token as the piece to classify.
+4. Attempt to classify the token into various categories in the following order:
    - **Keyword**:
      - Use `seperateKeywordToken` to separate the keyword part of the token.
-     - If it is recognized as a keyword, increment the keyword count and log it.
+     - If it is recognized as a keyword, report it as a keyword.
      - If there are trailing characters, recursively process them as a new token.
    - **Identifier**:
      - Use `seperateIdentifierToken` to separate the identifier part of the token.
-     - If it is recognized as a valid identifier, increment the identifier count and log it.
+     - If it is recognized as a valid identifier, report it as an identifier.
      - If there are trailing characters, recursively process them as a new token.
    - **Number**:
      - Use `seperateNumToken` to separate the number part of the token.
-     - If it is recognized as a valid number, increment the number count and log it.
+     - If it is recognized as a valid number, report it as a number.
      - If there are trailing characters, recursively process them as a new token.
    - **Punctuation**:
      - Use `seperatePunctuationToken` to separate the punctuation part of the token.
-     - If it is recognized as a valid punctuation character, increment the punctuation count and log it.
+     - If it is recognized as a valid punctuation character, report it as punctuation.
      - If there are trailing characters, recursively process them as a new token.
    - **Operator**:
      - Use `separateOperatorToken` to separate the operator part of the token.
-     - If it is recognized as a valid operator, increment the operator count and log it.
+     - If it is recognized as a valid operator, report it as an operator.
      - If there are trailing characters, recursively process them as a new token.
-4. If none of the categories match, classify the token as invalid, increment the invalid token count, and log an error message.
+5. If none of the categories match, report the whole token as invalid.
+6. All counting and output is done by `reportToken`.
+7. `offset` is the position of the token in the source. The part that is reported and the trailing characters that are processed again get their own offsets from it, so every token in the stream points at its exact lexeme.
+8. "Recursively process" is a loop: the characters split off become the token of the next pass, since they are always processed last. All parts are views into the caller's buffer, so no strings are built, and the separate* helpers share a `SplitCache`, so a long glued run is split in time linear in its length.
+9. With metrics on (`setMetrics`), every token passes `LexerMetrics::sampleNext` first; a sampled token is classified inside a timer, and `reportToken` times its report lines.
 </summary>*/
-void Lexical::processToken(const std::string& token, int lineNum)
+void Lexical::processToken(std::string_view token, size_t offset, int lineNum)
 {
+    if (metricsEnabled && !timingToken && metrics.sampleNext())
+    {
+        timingToken = true;
+        reportNanos = 0;
+        reportSpans = 0;
+        LexerMetrics::Clock::time_point start = LexerMetrics::Clock::now();
+        processToken(token, offset, lineNum);
+        metrics.recordToken(LexerMetrics::nanosSince(start), reportNanos, reportSpans);
+        timingToken = false;
+        return;
+    }
+
     if (token.empty())
     {
         //cout << "No Tokens\n";
-        tokenFile << std::left
-            << std::setw(20) << "No Tokens"
-            << std::setw(20) << "N/A" << "\n";
-        symbolTableFile << std::left
-            << std::setw(20) << "No Tokens"
-            << std::setw(20) << "N/A"
-            << std::setw(10) << "N/A"
-            << std::setw(10) << "N/A" << "\n";
+        if (tokenFile.is_open())
+        {
+            tokenFile.column("No Tokens", 20)
+                .column("N/A", 20).text("\n");
+        }
+        symbolTableFile.column("No Tokens", 20)
+            .column("N/A", 20)
+            .column("N/A", 10)
+            .column("N/A", 10).text("\n");
         return;
     }
 
-    bool isProcessed = false; // Tracks if the token has been classified
-    std::string tokenPart = token;
-    std::string lastChar = "";
-
-    // Keywords
-    seperateKeywordToken(token, tokenPart, lastChar);
-    if (isKeyword(tokenPart))
+    if (engine == ScanEngine::MergedDFA)
     {
-        nKeywords++;
-        std::cout << "Keyword: " << tokenPart << " at line " << lineNum << "\n";
-        tokenFile << std::left
-                  << std::setw(colWidthToken)  << tokenPart
-                  << std::setw(colWidthType)   << "Keyword"
-                  << "\n";
-
-        symbolTableFile                   << std::left
-            << std::setw(colWidthToken)   << tokenPart
-            << std::setw(colWidthType)    << "Keyword"
-            << std::setw(colWidthLine)    << lineNum
-            << std::setw(colWidthTokenNo) << tokenNo
-            << "\n";
-        isProcessed = true;
-        tokenNo++;
-        if (lastChar != "")
-            processToken(lastChar, lineNum);
+        scanMerged(token, offset, lineNum);
         return;
     }
-
-    // Identifier
-    seperateIdentifierToken(token, tokenPart, lastChar);
-    if (!isProcessed && identifierFSM(tokenPart) == 3) // Valid identifier state
+    if (engine == ScanEngine::Specification)
     {
-        nIdentifiers++;
-        std::cout << "Identifier: " << tokenPart << " at line " << lineNum << "\n";
-        tokenFile << std::left
-                  << std::setw(colWidthToken) << tokenPart
-                  << std::setw(colWidthType)  << "Identifier"
-                  << "\n";
-
-        symbolTableFile << std::left
-                        << std::setw(colWidthToken)   << tokenPart
-                        << std::setw(colWidthType)    << "Identifier"
-                        << std::setw(colWidthLine)    << lineNum
-                        << std::setw(colWidthTokenNo) << tokenNo
-                        << "\n";
-        isProcessed = true;
-        tokenNo++;
-        if (lastChar != "")
-            processToken(lastChar, lineNum);
+        scanSpecified(token, offset, lineNum);
         return;
     }
 
-    // Number
-    seperateNumToken(token, tokenPart, lastChar);
-    if (!isProcessed && numberFSM(tokenPart) != -1) // Valid number states
+    SplitCache splitCache;
+    std::string_view tokenPart;
+    std::string_view lastChar;
+
+    // Each pass classifies the front piece of `token`; the characters split off are classified in the next pass
+    while (!token.empty())
     {
-        nNumbers++;
-        std::cout << "Number: " << tokenPart << " at line " << lineNum << "\n";
-        tokenFile << std::left
-                  << std::setw(colWidthToken) << tokenPart
-                  << std::setw(colWidthType)  << "Number"
-                  << "\n";
-
-        symbolTableFile << std::left
-                        << std::setw(colWidthToken)   << tokenPart
-                        << std::setw(colWidthType)    << "Number"
-                        << std::setw(colWidthLine)    << lineNum
-                        << std::setw(colWidthTokenNo) << tokenNo
-                        << "\n";
-        isProcessed = true;
-        tokenNo++;
-        if (lastChar != "")
-            processToken(lastChar, lineNum);
-        return;
+        // Keywords
+        seperateKeywordToken(token, tokenPart, lastChar);
+        if (isKeyword(tokenPart))
+        {
+            reportToken(TokenKind::Keyword, tokenPart, offset, lineNum);
+            offset += tokenPart.length();
+            token = lastChar;
+            continue;
+        }
+
+        // Identifier
+        seperateIdentifierToken(token, tokenPart, lastChar, &splitCache);
+        if (identifierFSM(tokenPart) == 3) // Valid identifier state
+        {
+            reportToken(TokenKind::Identifier, tokenPart, offset, lineNum);
+            offset += tokenPart.length();
+            token = lastChar;
+            continue;
+        }
+
+        // Number
+        seperateNumToken(token, tokenPart, lastChar, &splitCache);
+        if (numberFSM(tokenPart) != -1) // Valid number states
+        {
+            reportToken(TokenKind::Number, tokenPart, offset, lineNum);
+            offset += tokenPart.length();
+            token = lastChar;
+            continue;
+        }
+
+        // Punctuation
+        seperatePunctuationToken(token, tokenPart, lastChar, &splitCache);
+        if (tokenPart.length() == 1 && punctuationFSM(tokenPart) != -1)
+        {
+            reportToken(TokenKind::Punctuation, tokenPart, offset, lineNum);
+            offset += tokenPart.length();
+            token = lastChar;
+            continue;
+        }
+
+        // Operator
+        separateOperatorToken(token, tokenPart, lastChar, &splitCache);
+        if (operatorFSM(tokenPart) != -1)
+        {
+            // The characters split off are either a prefix or a suffix of the token, never both
+            bool lastCharIsPrefix = !lastChar.empty() && lastChar.data() == token.data();
+
+            reportToken(TokenKind::Operator, tokenPart, lastCharIsPrefix ? offset + lastChar.length() : offset, lineNum);
+            if (!lastCharIsPrefix)
+                offset += tokenPart.length();
+            token = lastChar;
+            continue;
+        }
+
+        // Invalid Token
+        reportToken(TokenKind::Invalid, token, offset, lineNum);
+        break;
+    }
+}
+
+/* <summary>
+This function classifies all lexemes of a token with the merged DFA in one left-to-right pass, using longest-match (maximal munch) semantics.
+
+Logic:
+1. Starting at `pos`, feed bytes through `mergedTransitions` until the DFA has no transition (every machine rejected) or the token ends. Each byte costs one class lookup and one table load.
+2. While walking, accumulate the lexeme's intern hash (`InternTable::hashStep`) and remember:
+   - `acceptEnd`/`acceptKind`/`acceptHash`: the end, kind and hash of the longest prefix accepted by any machine.
+   - `keywordEnd`/`keywordHash`: the end and hash of the longest prefix that is a keyword candidate (letters and digits after a letter).
+3. Pick the lexeme that starts at `pos`:
+   - If the keyword candidate is longer than the accepted prefix and `isKeyword` accepts it, it is a keyword.
+   - Otherwise, if some prefix was accepted, it is a token of `acceptKind`.
+   - Otherwise, the characters the DFA could still read (at least one) form an invalid lexeme.
+4. Report the lexeme with `reportToken`, move `pos` past it and repeat until the token is consumed.
+
+With `LEXICAL_DIRECT_CODED` defined, step 1 and 2 are the generated direct-coded function `DirectScanner::merged` (see `Scanner Generator.cpp`) instead of the table walk, and the hashes are computed from the lexemes afterwards.
+
+Compared with the cascade, glued runs are split by longest match instead of by the separate* helpers, e.g. `<<` is one operator rather than two punctuation tokens, and `1rate` is the number `1` followed by the invalid lexeme `rate`.
+</summary>*/
+void Lexical::scanMerged(std::string_view token, size_t offset, int lineNum)
+{
+    const size_t length = token.length();
+    size_t pos = 0;
+
+    while (pos < length)
+    {
+        size_t i = pos;
+        size_t acceptEnd = pos;
+        size_t keywordEnd = pos;
+        TokenKind acceptKind = TokenKind::Invalid;
+
+#ifdef LEXICAL_DIRECT_CODED
+        const char* base = token.data();
+        const char* acceptPtr = base + pos;
+        const char* keywordPtr = base + pos;
+        i = DirectScanner::merged(base + pos, base + length, acceptPtr, acceptKind, keywordPtr) - base;
+        acceptEnd = acceptPtr - base;
+        keywordEnd = keywordPtr - base;
+        uint32_t acceptHash = InternTable::hash(token.substr(pos, acceptEnd - pos));
+        uint32_t keywordHash = InternTable::hash(token.substr(pos, keywordEnd - pos));
+#else
+        const ScannerDefinition& dfa = *definition;
+        int state = 0;
+        uint32_t hash = InternTable::hashSeed;
+        uint32_t acceptHash = hash;
+        uint32_t keywordHash = hash;
+        while (i < length)
+        {
+            int next = dfa.mergedTransitions[state * dfa.mergedClassCount + dfa.mergedClass[static_cast<unsigned char>(token[i])]];
+            if (next < 0)
+                break;
+            state = next;
+            hash = InternTable::hashStep(hash, token[i]);
+            i++;
+
+            if (dfa.mergedAccept[state] != TokenKind::Invalid)
+            {
+                acceptEnd = i;
+                acceptKind = dfa.mergedAccept[state];
+                acceptHash = hash;
+            }
+            if (dfa.mergedKeywordCandidate[state])
+            {
+                keywordEnd = i;
+                keywordHash = hash;
+            }
+        }
+#endif
+
+        if (keywordEnd > acceptEnd && isKeyword(token.substr(pos, keywordEnd - pos)))
+        {
+            reportToken(TokenKind::Keyword, token.substr(pos, keywordEnd - pos), offset + pos, lineNum, keywordHash);
+            pos = keywordEnd;
+        }
+        else if (acceptEnd > pos)
+        {
+            reportToken(acceptKind, token.substr(pos, acceptEnd - pos), offset + pos, lineNum, acceptHash);
+            pos = acceptEnd;
+        }
+        else
+        {
+            size_t invalidEnd = (i > pos) ? i : pos + 1;
+            reportToken(TokenKind::Invalid, token.substr(pos, invalidEnd - pos), offset + pos, lineNum);
+            pos = invalidEnd;
+        }
+    }
+}
+
+/* <summary>
+This function classifies all lexemes of a token with the DFA of the lexer specification, with a longest-match loop like the one of `scanMerged`, minus its keyword-candidate step.
+
+Logic:
+1. Starting at `pos`, feed bytes through the DFA until it has no transition or the token ends, remembering the end, kind and intern hash of the longest accepted prefix. Each byte costs one class lookup and one table load, however many rules the specification has.
+2. If some prefix was accepted, report it with its kind. Keywords need no extra lookup here: they are rules of the specification like any other token class.
+3. Otherwise the characters the DFA could still read (at least one) form an invalid lexeme. Minimization removes the states from which no rule can accept any more, so this never runs past the point where a token became impossible.
+4. Move `pos` past the lexeme and repeat until the token is consumed.
+
+Whole lexemes get the same kinds as with `scanMerged`, but glued runs can split differently. `scanMerged` reports a keyword only when the longest keyword candidate (the whole run of letters and digits) is one, while here the keyword rule competes for the longest match like any other rule. E.g. `}dos)` gives the keyword `do` and the invalid lexeme `s` here, but the invalid lexeme `dos` with `ScanEngine::MergedDFA`, so the token counts of the two engines differ on such input.
+</summary>*/
+void Lexical::scanSpecified(std::string_view token, size_t offset, int lineNum)
+{
+    const LexerDFA& dfa = *definition->specDFA;
+    const size_t length = token.length();
+    size_t pos = 0;
+
+    while (pos < length)
+    {
+        int state = 0;
+        size_t i = pos;
+        size_t acceptEnd = pos;
+        TokenKind acceptKind = TokenKind::Invalid;
+        uint32_t hash = InternTable::hashSeed;
+        uint32_t acceptHash = hash;
+
+        while (i < length)
+        {
+            int next = dfa.transitions[state * dfa.classCount + dfa.classOf[static_cast<unsigned char>(token[i])]];
+            if (next < 0)
+                break;
+            state = next;
+            hash = InternTable::hashStep(hash, token[i]);
+            i++;
+
+            if (dfa.accept[state] != TokenKind::Invalid)
+            {
+                acceptEnd = i;
+                acceptKind = dfa.accept[state];
+                acceptHash = hash;
+            }
+        }
+
+        if (acceptEnd > pos)
+        {
+            reportToken(acceptKind, token.substr(pos, acceptEnd - pos), offset + pos, lineNum, acceptHash);
+            pos = acceptEnd;
+        }
+        else
+        {
+            size_t invalidEnd = (i > pos) ? i : pos + 1;
+            reportToken(TokenKind::Invalid, token.substr(pos, invalidEnd - pos), offset + pos, lineNum);
+            pos = invalidEnd;
+        }
     }
+}
+
+/* <summary>
+This function records one classified lexeme: it appends it to the token stream, updates the counters and writes the console line, the `tokenFile` row and the `symbolTableFile` row, or the error line for invalid lexemes.
+
+Logic:
+1. Append the token (kind, offset, length, line and interned id) to `tokens`; invalid lexemes are appended too, with `TokenKind::Invalid`. On the per-chunk instances of `scanParallel` (`deferOutput`), stop here.
+   The DFA engines pass the lexeme's intern hash, accumulated while they read it (`lexemeHash`); otherwise it is computed here.
+2. Increment the counter of the token's category and pick its display name.
+3. For invalid lexemes, log the error to the console and `errorFile` and stop; invalid lexemes do not get a token number.
+4. For valid tokens, log "<Type>: <lexeme> at line <n>" to the console, write the token and its type to `tokenFile`, and the token, type, line and token number to `symbolTableFile`.
+5. Increment `tokenNo`.
+6. Console lines are only formatted at `Verbosity::Verbose`, and file rows only for enabled artifacts.
+</summary>*/
+void Lexical::reportToken(TokenKind kind, std::string_view lexeme, size_t offset, int lineNum)
+{
+    reportToken(kind, lexeme, offset, lineNum, InternTable::hash(lexeme));
+}
+
+void Lexical::reportToken(TokenKind kind, std::string_view lexeme, size_t offset, int lineNum, uint32_t lexemeHash)
+{
+    tokens.append(kind, offset, lexeme, lineNum, lexemeHash);
+    if (deferOutput)
+        return;
+    reportSpans += timingToken;
+    LexerMetrics::Stopwatch reportTime(timingToken ? &reportNanos : nullptr);
 
-    // Punctuation
-    seperatePunctuationToken(token, tokenPart, lastChar);
-    if (!isProcessed && tokenPart.length() == 1 && punctuationFSM(tokenPart) != -1)
+    const char* typeName = "";
+    switch (kind)
     {
+    case TokenKind::Keyword:
+        nKeywords++;
+        typeName = "Keyword";
+        break;
+    case TokenKind::Identifier:
+        nIdentifiers++;
+        typeName = "Identifier";
+        break;
+    case TokenKind::Number:
+        nNumbers++;
+        typeName = "Number";
+        break;
+    case TokenKind::Punctuation:
         nPunctuations++;
-        std::cout << "Punctuation: " << tokenPart << " at line " << lineNum << "\n";
-        tokenFile << std::left
-                  << std::setw(colWidthToken) << tokenPart
-                  << std::setw(colWidthType)  << "Punctuation"
-                  << "\n";
-
-        symbolTableFile << std::left
-                        << std::setw(colWidthToken)   << tokenPart
-                        << std::setw(colWidthType)    << "Punctuation"
-                        << std::setw(colWidthLine)    << lineNum
-                        << std::setw(colWidthTokenNo) << tokenNo
-                        << "\n";
-        isProcessed = true;
-        tokenNo++;
-        if (lastChar != "")
-            processToken(lastChar, lineNum);
+        typeName = "Punctuation";
+        break;
+    case TokenKind::Operator:
+        nOperators++;
+        typeName = "Operator";
+        break;
+    case TokenKind::Invalid:
+        nInvalid++;
+        if (console.is_open())
+            console.text("Error: Invalid token \"").text(lexeme).text("\" at line ").number(lineNum).text("\n");
+        errorFile.text("Error: Invalid token \"").text(lexeme).text("\" at line ").number(lineNum).text("\n");
         return;
     }
 
-    // Operator
-    separateOperatorToken(token, tokenPart, lastChar);
-    if (!isProcessed && operatorFSM(tokenPart) != -1)
+    if (console.is_open())
+        console.text(typeName).text(": ").text(lexeme).text(" at line ").number(lineNum).text("\n");
+    if (tokenFile.is_open())
     {
-        nOperators++;
-        std::cout << "Operator: " << tokenPart << " at line " << lineNum << "\n";
-        tokenFile << std::left
-                  << std::setw(colWidthToken) << tokenPart
-                  << std::setw(colWidthType)  << "Operator"
-                  << "\n";
-
-        symbolTableFile << std::left
-                        << std::setw(colWidthToken)   << tokenPart
-                        << std::setw(colWidthType)    << "Operator"
-                        << std::setw(colWidthLine)    << lineNum
-                        << std::setw(colWidthTokenNo) << tokenNo
-                        << "\n";
-        isProcessed = true;
-        tokenNo++;
-        if (lastChar != "")
-            processToken(lastChar, lineNum);
+        tokenFile.column(lexeme, colWidthToken)
+                 .column(typeName, colWidthType)
+                 .text("\n");
+    }
+
+    if (symbolTableFile.is_open())
+    {
+        symbolTableFile.column(lexeme, colWidthToken)
+                       .column(typeName, colWidthType)
+                       .column(lineNum, colWidthLine)
+                       .column(tokenNo, colWidthTokenNo)
+                       .text("\n");
+    }
+    tokenNo++;
+}
+
+// |-------------------------------------------------------------------------------------------------------------|
+// |                                          Incremental Re-lexing                                              |
+// |-------------------------------------------------------------------------------------------------------------|
+
+/* <summary>
+This function lexes a source held in memory (e.g. an editor buffer) into the token stream, the starting point for `relex`. It resets the counters and the stream and writes no files and no console output; the tokens are the same as `PerformLexical` produces for a file with this content.
+A source larger than `TokenStream::maxSourceSize` is rejected with an error message and leaves the stream empty.
+</summary>*/
+void Lexical::lexText(std::string_view source)
+{
+    if (metricsEnabled)
+        metrics.begin();
+    resetRun();
+    if (source.size() > TokenStream::maxSourceSize)
+    {
+        std::cerr << "Error: Source is larger than 4 GiB, the largest source the token stream can address.\n";
         return;
     }
 
-    // Invalid Token
-    if (!isProcessed)
+    bool deferred = deferOutput;
+    deferOutput = true;
+    LexerMetrics::Stopwatch scanTime(phaseTimer(LexPhase::Scan));
+    scanBuffer(source.data(), source.size());
+    scanTime.stop();
+    deferOutput = deferred;
+
+    for (size_t i = 0; i < tokens.size(); ++i)
+        countToken(tokens.kind(i), 1);
+    if (metricsEnabled)
+        metrics.finish(tokens, source.size());
+}
+
+/* <summary>
+This function applies an edit to `source` and updates the token stream for it, re-lexing only the part of the source the edit can affect. `source` must be the text the stream was produced from (by `PerformLexical` on the same content, `lexText` or earlier `relex` calls).
+
+Logic:
+1. Reject edits outside the source, and edits after which the source would be larger than `TokenStream::maxSourceSize`. Count the newlines the edit removes and inserts, then apply it to `source`.
+2. Find the re-lexed range. Tokens never span a delimiter and each delimited run is lexed on its own, so the token stream resynchronizes at the first delimiter on either side of the edit: the range runs from the start of the run the edit touches to the end of the run that follows the inserted text.
+3. Find the old tokens of that range: runs are reported in source order, so the tokens before the range are exactly those with an offset before its start, and the tokens after it are those with an (old) offset at or after its (old) end. Both are found by binary search on the offsets.
+4. Take the line of the range start from the last token before it, plus the newlines between that token and the range start.
+5. Lex the range into the scratch stream with `scanBuffer` (output deferred, so nothing is counted or written), splice it over the old tokens with the range start and line as bases, and shift the offsets and lines of all later tokens by the size and newline difference of the edit.
+6. Update the counters for the removed and inserted tokens. Token numbers are not stored in the stream; `tokenNoShift` tells by how much those of the later tokens move.
+7. The work is proportional to the size of the range plus one pass over the offsets and lines of the later tokens, not to the size of the source.
+</summary>*/
+Lexical::RelexResult Lexical::relex(std::string& source, const TextEdit& edit)
+{
+    RelexResult result;
+    if (edit.offset > source.size() || edit.length > source.size() - edit.offset)
+        return result;
+    if (source.size() - edit.length + edit.replacement.size() > TokenStream::maxSourceSize)
+        return result;
+
+    const char* removed = source.data() + edit.offset;
+    result.lineShift = static_cast<int>(std::count(edit.replacement.begin(), edit.replacement.end(), '\n'))
+        - static_cast<int>(std::count(removed, removed + edit.length, '\n'));
+    result.offsetShift = static_cast<long long>(edit.replacement.size()) - static_cast<long long>(edit.length);
+    source.replace(edit.offset, edit.length, edit.replacement.data(), edit.replacement.size());
+
+    const char* data = source.data();
+    size_t rangeStart = edit.offset;
+    while (rangeStart > 0 && !isDelimiter(data[rangeStart - 1]))
+        rangeStart--;
+    size_t rangeEnd = DelimiterScan::findDelimiter(data, edit.offset + edit.replacement.size(), source.size());
+    size_t oldRangeEnd = rangeEnd - edit.replacement.size() + edit.length;
+
+    const uint32_t* offsets = tokens.offsetData();
+    size_t first = std::partition_point(offsets, offsets + tokens.size(), [rangeStart](uint32_t offset) { return offset < rangeStart; }) - offsets;
+    size_t last = std::partition_point(offsets + first, offsets + tokens.size(), [oldRangeEnd](uint32_t offset) { return offset < oldRangeEnd; }) - offsets;
+
+    int lineBase = 1;
+    size_t countFrom = 0;
+    if (first > 0)
     {
-        nInvalid++;
-        std::cout << "Error: Invalid token \"" << token << "\" at line " << lineNum << "\n";
-        errorFile << "Error: Invalid token \"" << token << "\" at line " << lineNum << "\n";
+        lineBase = static_cast<int>(tokens.line(first - 1));
+        countFrom = tokens.offset(first - 1);
     }
+    lineBase += static_cast<int>(std::count(data + countFrom, data + rangeStart, '\n'));
+
+    relexTokens.clear();
+    std::swap(tokens, relexTokens);
+    bool deferred = deferOutput;
+    deferOutput = true;
+    scanBuffer(data + rangeStart, rangeEnd - rangeStart);
+    deferOutput = deferred;
+    std::swap(tokens, relexTokens);
+
+    int validBefore = tokenNo;
+    for (size_t i = first; i < last; ++i)
+        countToken(tokens.kind(i), -1);
+    for (size_t i = 0; i < relexTokens.size(); ++i)
+        countToken(relexTokens.kind(i), 1);
+
+    tokens.splice(first, last, relexTokens, rangeStart, lineBase - 1);
+    tokens.shift(first + relexTokens.size(), result.offsetShift, result.lineShift);
+
+    result.applied = true;
+    result.firstToken = first;
+    result.removedTokens = last - first;
+    result.insertedTokens = relexTokens.size();
+    result.tokenNoShift = tokenNo - validBefore;
+    return result;
+}
+
+/* <summary>
+This function adds `delta` to the counter of a token kind and, for valid tokens, to `tokenNo`, the number of valid tokens.
+</summary>*/
+void Lexical::countToken(TokenKind kind, int delta)
+{
+    switch (kind)
+    {
+    case TokenKind::Keyword:
+        nKeywords += delta;
+        break;
+    case TokenKind::Identifier:
+        nIdentifiers += delta;
+        break;
+    case TokenKind::Number:
+        nNumbers += delta;
+        break;
+    case TokenKind::Punctuation:
+        nPunctuations += delta;
+        break;
+    case TokenKind::Operator:
+        nOperators += delta;
+        break;
+    case TokenKind::Invalid:
+        nInvalid += delta;
+        return;
+    }
+    tokenNo += delta;
+}
+
+/* <summary>
+This function starts a new run on this instance: the token counters and the token stream are reset, so `PerformLexical` and `lexText` give the same results on a reused instance as on a fresh one. The settings (input mode, engine, artifacts, sink) and the definition are kept.
+</summary>*/
+void Lexical::resetRun()
+{
+    tokenNo = nKeywords = nIdentifiers = nNumbers = nPunctuations = nOperators = nInvalid = 0;
+    tokens.clear();
+}
+
+/* <summary>
+This function gives access to the tokens of the last `PerformLexical` run as an in-memory, struct-of-arrays token stream (see `TokenStream`). The stream holds the same tokens, in the same order, as `tokenFile` plus the invalid lexemes, so a caller can hand it to the parser without reading `tokenLex.txt` back.
+</summary>*/
+const TokenStream& Lexical::getTokens() const
+{
+    return tokens;
 }
 
 #endif // LEXICAL_H
\ No newline at end of file
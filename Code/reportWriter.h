@@ -0,0 +1,187 @@
+#ifndef REPORT_WRITER_H
+#define REPORT_WRITER_H
+
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include "diagnostics.h"
+
+/* <summary>
+The `ReportWriter` class is the output layer of the lexer reports (`tokenLex.txt`, `symbolTable.txt`, `error.txt` and the console log). It formats text, left-aligned fixed-width columns and integers into a large in-memory buffer and hands the buffer to the stream in one `write` when it is full or the writer is flushed.
+
+Logic:
+1. A writer either owns a file (`open`) or forwards to a `DiagnosticSink` such as `consoleSink()` (`attach`). Files are opened in text mode, exactly like the `std::ofstream` members the writer replaces, so line endings stay the same on every platform.
+2. `column` matches `std::left << std::setw(width) << value`: the value is written as is and padded with spaces up to `width`; a longer value is not truncated. Integers are formatted with `std::to_chars`, without locale or stream-state lookups.
+3. The buffer is allocated on the first `open`/`attach`, so idle writers (e.g. on the per-chunk instances of `Lexical::scanParallel`) cost nothing. Text larger than the buffer bypasses it.
+4. `close` flushes and closes an owned file, or flushes and detaches a sink; the destructor closes as well.
+5. A writer that is not open ignores all output, so a disabled artifact costs no I/O.
+</summary>*/
+class ReportWriter
+{
+private:
+    std::ofstream file;
+    StreamSink fileSink{ file };
+    DiagnosticSink* target = nullptr;
+    std::unique_ptr<char[]> buffer;
+    size_t capacity;
+    size_t used = 0;
+
+    void allocate();
+    char* reserve(size_t count);
+
+public:
+    explicit ReportWriter(size_t bufferSize = size_t(1) << 20) : capacity(bufferSize) {}
+    ~ReportWriter() { close(); }
+    ReportWriter(const ReportWriter&) = delete;
+    ReportWriter& operator=(const ReportWriter&) = delete;
+
+    bool open(const std::string& fileName);
+    void attach(DiagnosticSink& sink);
+    bool is_open() const { return target != nullptr; }
+    void flush();
+    void close();
+
+    ReportWriter& text(std::string_view value);
+    ReportWriter& fill(char c, size_t count);
+    ReportWriter& number(long long value);
+    ReportWriter& column(std::string_view value, int width);
+    ReportWriter& column(long long value, int width);
+};
+
+/* <summary>
+This function allocates the buffer once.
+</summary>*/
+void ReportWriter::allocate()
+{
+    if (!buffer)
+        buffer.reset(new char[capacity]);
+    used = 0;
+}
+
+/* <summary>
+This function opens `fileName` for writing (truncating it) and makes it the target. It returns `false` if the file cannot be opened.
+</summary>*/
+bool ReportWriter::open(const std::string& fileName)
+{
+    close();
+    file.open(fileName);
+    if (!file.is_open())
+        return false;
+    allocate();
+    target = &fileSink;
+    return true;
+}
+
+/* <summary>
+This function makes a diagnostic sink the target; the writer does not own it.
+</summary>*/
+void ReportWriter::attach(DiagnosticSink& sink)
+{
+    close();
+    allocate();
+    target = &sink;
+}
+
+/* <summary>
+This function writes the buffered bytes to the target in one call.
+</summary>*/
+void ReportWriter::flush()
+{
+    if (target && used > 0)
+        target->write(std::string_view(buffer.get(), used));
+    used = 0;
+}
+
+/* <summary>
+This function flushes the buffer and releases the target, closing it if the writer owns it.
+</summary>*/
+void ReportWriter::close()
+{
+    flush();
+    if (target == &fileSink)
+        file.close();
+    else if (target)
+        target->flush();
+    target = nullptr;
+}
+
+/* <summary>
+This function returns room for `count` more bytes in the buffer, flushing first if they do not fit. `count` must not exceed the capacity.
+</summary>*/
+char* ReportWriter::reserve(size_t count)
+{
+    if (capacity - used < count)
+        flush();
+    return buffer.get() + used;
+}
+
+/* <summary>
+This function appends text as is. Text that does not fit into an empty buffer is written directly.
+</summary>*/
+ReportWriter& ReportWriter::text(std::string_view value)
+{
+    if (!target)
+        return *this;
+    if (value.size() > capacity)
+    {
+        flush();
+        target->write(value);
+        return *this;
+    }
+    std::memcpy(reserve(value.size()), value.data(), value.size());
+    used += value.size();
+    return *this;
+}
+
+/* <summary>
+This function appends `count` copies of `c` (column padding and separator rules).
+</summary>*/
+ReportWriter& ReportWriter::fill(char c, size_t count)
+{
+    if (!target)
+        return *this;
+    while (count > 0)
+    {
+        size_t step = count < capacity ? count : capacity;
+        std::memset(reserve(step), c, step);
+        used += step;
+        count -= step;
+    }
+    return *this;
+}
+
+/* <summary>
+This function appends an integer in decimal, formatted with `std::to_chars` (at most 20 characters).
+</summary>*/
+ReportWriter& ReportWriter::number(long long value)
+{
+    if (!target)
+        return *this;
+    char* begin = reserve(20);
+    used += static_cast<size_t>(std::to_chars(begin, begin + 20, value).ptr - begin);
+    return *this;
+}
+
+/* <summary>
+These functions append a value left-aligned in a column of `width` characters.
+</summary>*/
+ReportWriter& ReportWriter::column(std::string_view value, int width)
+{
+    text(value);
+    if (value.size() < static_cast<size_t>(width))
+        fill(' ', static_cast<size_t>(width) - value.size());
+    return *this;
+}
+
+ReportWriter& ReportWriter::column(long long value, int width)
+{
+    char digits[20];
+    size_t length = static_cast<size_t>(std::to_chars(digits, digits + 20, value).ptr - digits);
+    return column(std::string_view(digits, length), width);
+}
+
+#endif // REPORT_WRITER_H
@@ -0,0 +1,211 @@
+#ifndef SOURCE_BUFFER_H
+#define SOURCE_BUFFER_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+/* <summary>
+The `SourceBuffer` class exposes the complete content of an input file as one contiguous, read-only block of bytes, so the scanner can walk it with plain pointer arithmetic instead of going through iostreams.
+
+Logic:
+1. Regular files are memory-mapped (`mmap` on POSIX, `CreateFileMapping`/`MapViewOfFile` on Windows). The operating system pages the file in on demand and no copy of the content is made.
+2. Anything that cannot be mapped (pipes, character devices, empty files, or a failed mapping) falls back to reading the whole stream with `read()`/`ReadFile` into an internal growable buffer.
+3. `data()` and `size()` describe the content in both cases, `isMapped()` reports which of the two paths was taken.
+4. The mapping (or the fallback buffer) stays valid until `close()` is called or the object is destroyed.
+</summary>*/
+class SourceBuffer
+{
+private:
+    const char* view = nullptr;
+    size_t length = 0;
+    bool mapped = false;
+
+    // Fallback storage for inputs that cannot be mapped
+    std::vector<char> storage;
+
+#ifdef _WIN32
+    using NativeHandle = HANDLE;
+    HANDLE fileHandle = INVALID_HANDLE_VALUE;
+    HANDLE mappingHandle = nullptr;
+#else
+    using NativeHandle = int;
+#endif
+
+    bool readAll(NativeHandle handle);
+
+public:
+    SourceBuffer() = default;
+    ~SourceBuffer();
+    SourceBuffer(const SourceBuffer&) = delete;
+    SourceBuffer& operator=(const SourceBuffer&) = delete;
+
+    bool open(const std::string& fileName);
+    void close();
+
+    const char* data() const { return view; }
+    size_t size() const { return length; }
+    bool isMapped() const { return mapped; }
+};
+
+/* <summary>
+This function releases the mapping or the fallback buffer when the object goes out of scope.
+</summary>*/
+SourceBuffer::~SourceBuffer()
+{
+    close();
+}
+
+/* <summary>
+This function opens a file and makes its whole content available through `data()`/`size()`.
+
+Logic:
+1. Release anything a previous `open` may still hold.
+2. Open the file read-only. If that fails, return `false`.
+3. If the file is a regular file with a non-zero size, try to map it into memory:
+   - On success, remember the view, mark the buffer as mapped and return `true`. The file handle is not needed once the view exists (POSIX) or is kept together with the mapping handle (Windows).
+4. Otherwise (pipe, device, empty file or a failed mapping) read the whole stream into `storage` with `readAll` and point the view at it.
+5. Return whether the content could be obtained.
+</summary>*/
+bool SourceBuffer::open(const std::string& fileName)
+{
+    close();
+
+#ifdef _WIN32
+    fileHandle = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (GetFileType(fileHandle) == FILE_TYPE_DISK && GetFileSizeEx(fileHandle, &fileSize) && fileSize.QuadPart > 0)
+    {
+        mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mappingHandle != nullptr)
+        {
+            const void* address = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+            if (address != nullptr)
+            {
+                view = static_cast<const char*>(address);
+                length = static_cast<size_t>(fileSize.QuadPart);
+                mapped = true;
+                return true;
+            }
+            CloseHandle(mappingHandle);
+            mappingHandle = nullptr;
+        }
+    }
+
+    bool ok = readAll(fileHandle);
+    CloseHandle(fileHandle);
+    fileHandle = INVALID_HANDLE_VALUE;
+    return ok;
+#else
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0)
+    {
+        void* address = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address != MAP_FAILED)
+        {
+            madvise(address, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+            ::close(fd);
+            view = static_cast<const char*>(address);
+            length = static_cast<size_t>(info.st_size);
+            mapped = true;
+            return true;
+        }
+    }
+
+    bool ok = readAll(fd);
+    ::close(fd);
+    return ok;
+#endif
+}
+
+/* <summary>
+This function reads an unmappable input (pipe, device, empty file) until end of stream into the fallback buffer.
+
+Logic:
+1. Grow `storage` in large steps and read directly into its free tail, so the data is copied exactly once.
+2. Stop on end of stream; a read error makes the function return `false`.
+3. Shrink the logical size to the number of bytes actually read and point the view at the buffer.
+</summary>*/
+bool SourceBuffer::readAll(NativeHandle handle)
+{
+    const size_t chunkSize = 1 << 20;
+    size_t used = 0;
+
+    while (true)
+    {
+        if (storage.size() - used < chunkSize)
+            storage.resize(used + chunkSize);
+
+#ifdef _WIN32
+        DWORD got = 0;
+        if (!ReadFile(handle, storage.data() + used, static_cast<DWORD>(chunkSize), &got, nullptr))
+        {
+            if (GetLastError() != ERROR_BROKEN_PIPE)
+                return false;
+        }
+#else
+        ssize_t got = ::read(handle, storage.data() + used, chunkSize);
+        if (got < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+#endif
+        if (got == 0)
+            break;
+        used += static_cast<size_t>(got);
+    }
+
+    storage.resize(used);
+    view = storage.data();
+    length = used;
+    mapped = false;
+    return true;
+}
+
+/* <summary>
+This function releases the current content: it unmaps the view (and closes the Windows handles) for mapped files, or frees the fallback buffer otherwise.
+</summary>*/
+void SourceBuffer::close()
+{
+    if (mapped && view != nullptr)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(view);
+        CloseHandle(mappingHandle);
+        CloseHandle(fileHandle);
+        mappingHandle = nullptr;
+        fileHandle = INVALID_HANDLE_VALUE;
+#else
+        munmap(const_cast<char*>(view), length);
+#endif
+    }
+    storage.clear();
+    storage.shrink_to_fit();
+    view = nullptr;
+    length = 0;
+    mapped = false;
+}
+
+#endif // SOURCE_BUFFER_H
@@ -0,0 +1,108 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/* <summary>
+The `ThreadPool` class runs submitted tasks on a fixed set of worker threads.
+
+Logic:
+1. The constructor starts the requested number of workers (at least one). Each worker waits on a condition variable and takes tasks from a shared FIFO queue.
+2. `submit` wraps a callable in a `std::packaged_task`, queues it and returns the matching `std::future`. An exception thrown by the task is stored in the future and rethrown by `get()`.
+3. The destructor lets the workers finish every queued task, then joins them.
+</summary>*/
+class ThreadPool
+{
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex queueMutex;
+    std::condition_variable queueChanged;
+    bool stopping = false;
+
+    void workerLoop();
+
+public:
+    explicit ThreadPool(unsigned threadCount);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return workers.size(); }
+
+    template <typename Task>
+    std::future<std::invoke_result_t<Task>> submit(Task task);
+};
+
+/* <summary>
+This constructor starts `threadCount` worker threads (one if `threadCount` is 0).
+</summary>*/
+ThreadPool::ThreadPool(unsigned threadCount)
+{
+    if (threadCount == 0)
+        threadCount = 1;
+    workers.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i)
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+}
+
+/* <summary>
+This destructor drains the queue and joins all workers.
+</summary>*/
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueChanged.notify_all();
+    for (std::thread& worker : workers)
+        worker.join();
+}
+
+/* <summary>
+This function is the body of every worker: take the oldest task and run it outside the lock, until the pool is stopping and the queue is empty.
+</summary>*/
+void ThreadPool::workerLoop()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueChanged.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if (tasks.empty())
+                return;
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+        task();
+    }
+}
+
+/* <summary>
+This function queues a task and returns a future for its result.
+</summary>*/
+template <typename Task>
+std::future<std::invoke_result_t<Task>> ThreadPool::submit(Task task)
+{
+    using Result = std::invoke_result_t<Task>;
+    auto packaged = std::make_shared<std::packaged_task<Result()>>(std::move(task));
+    std::future<Result> result = packaged->get_future();
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        tasks.emplace([packaged]() { (*packaged)(); });
+    }
+    queueChanged.notify_one();
+    return result;
+}
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,221 @@
+﻿#ifndef TOKEN_STREAM_H
+#define TOKEN_STREAM_H
+
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "internTable.h"
+
+// Token categories produced by the scanner
+enum class TokenKind : uint8_t
+{
+    Keyword,
+    Identifier,
+    Number,
+    Punctuation,
+    Operator,
+    Invalid
+};
+
+/* <summary>
+The `TokenStream` class holds the tokens of one `Lexical::PerformLexical` run in memory, so the parser can consume them directly instead of re-reading `tokenLex.txt`.
+
+Logic:
+1. Tokens are stored as parallel arrays (struct of arrays), one entry per token in the order the scanner reports them:
+   - `kind`: the `TokenKind` of the token (invalid lexemes are kept, marked `TokenKind::Invalid`).
+   - `offset`: the byte offset of the lexeme in the source.
+   - `length`: the length of the lexeme in bytes.
+   - `line`: the 1-based source line.
+   - `id`: the interned id of the lexeme text.
+2. Every distinct lexeme text is stored once, in an `InternTable`. Ids are dense and start at 0, in order of first appearance, so equal lexemes have equal ids and `text(id)` gives the spelling back. Consumers compare and hash the ids instead of the strings. A scanner that accumulated the lexeme's hash while reading it passes it to `append`, so interning does not read the text again.
+3. `shareLexemes` makes the stream intern into a `ConcurrentInternTable` instead, which several streams (usually on different threads) use at once. Ids then come from the shared table: they are dense over all streams, not per stream, and equal lexemes have equal ids in every stream that shares the table. `clear` leaves the shared table alone. A full shared table is an error (`std::length_error`); size it for the expected number of distinct lexemes.
+4. Offsets, lengths, lines and ids are 32-bit, which limits a single source to `maxSourceSize` bytes (4 GiB - 1). `append` and `splice` narrow without checking, so `Lexical` rejects larger inputs before scanning them.
+</summary>*/
+class TokenStream
+{
+private:
+    std::vector<TokenKind> kinds;
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> lengths;
+    std::vector<uint32_t> lines;
+    std::vector<uint32_t> ids;
+
+    // Interned lexemes; `shared` replaces `lexemes` when set
+    InternTable lexemes;
+    ConcurrentInternTable* shared = nullptr;
+
+    uint32_t internShared(std::string_view lexeme, uint32_t lexemeHash);
+
+    template <typename T>
+    static void resizeRange(std::vector<T>& column, size_t first, size_t last, size_t count);
+
+public:
+    // The largest source whose offsets fit into the 32-bit offset column
+    static constexpr size_t maxSourceSize = UINT32_MAX;
+
+    void clear();
+    void reserve(size_t count);
+
+    void shareLexemes(ConcurrentInternTable* table);
+    ConcurrentInternTable* sharedLexemes() const { return shared; }
+
+    uint32_t intern(std::string_view lexeme) { return shared ? internShared(lexeme, InternTable::hash(lexeme)) : lexemes.intern(lexeme); }
+    void append(TokenKind kind, size_t offset, std::string_view lexeme, int line) { append(kind, offset, lexeme, line, InternTable::hash(lexeme)); }
+    void append(TokenKind kind, size_t offset, std::string_view lexeme, int line, uint32_t lexemeHash);
+    void splice(size_t first, size_t last, const TokenStream& replacement, size_t offsetBase, int lineBase);
+    void shift(size_t first, long long offsetDelta, int lineDelta);
+
+    size_t size() const { return kinds.size(); }
+    bool empty() const { return kinds.empty(); }
+    size_t lexemeCount() const { return shared ? shared->size() : lexemes.size(); }
+
+    TokenKind kind(size_t index) const { return kinds[index]; }
+    uint32_t offset(size_t index) const { return offsets[index]; }
+    uint32_t length(size_t index) const { return lengths[index]; }
+    uint32_t line(size_t index) const { return lines[index]; }
+    uint32_t id(size_t index) const { return ids[index]; }
+    std::string_view lexeme(size_t index) const { return text(ids[index]); }
+    std::string_view text(uint32_t lexemeId) const { return shared ? shared->text(lexemeId) : lexemes.text(lexemeId); }
+    uint32_t hash(uint32_t lexemeId) const { return shared ? shared->hashOf(lexemeId) : lexemes.hashOf(lexemeId); }
+
+    // Raw column access for consumers that walk one array at a time
+    const TokenKind* kindData() const { return kinds.data(); }
+    const uint32_t* offsetData() const { return offsets.data(); }
+    const uint32_t* lengthData() const { return lengths.data(); }
+    const uint32_t* lineData() const { return lines.data(); }
+    const uint32_t* idData() const { return ids.data(); }
+};
+
+/* <summary>
+This function removes all tokens and the lexemes of the stream's own intern table; a shared table keeps its lexemes.
+</summary>*/
+void TokenStream::clear()
+{
+    kinds.clear();
+    offsets.clear();
+    lengths.clear();
+    lines.clear();
+    ids.clear();
+    lexemes.clear();
+}
+
+/* <summary>
+This function makes the stream intern into `table` (or into its own table again, for `nullptr`). The stream must be empty, because the ids of the two tables do not mix.
+</summary>*/
+void TokenStream::shareLexemes(ConcurrentInternTable* table)
+{
+    clear();
+    shared = table;
+}
+
+/* <summary>
+This function interns into the shared table and reports a full table.
+</summary>*/
+uint32_t TokenStream::internShared(std::string_view lexeme, uint32_t lexemeHash)
+{
+    uint32_t id = shared->intern(lexeme, lexemeHash);
+    if (id == ConcurrentInternTable::full)
+        throw std::length_error("shared intern table is full");
+    return id;
+}
+
+/* <summary>
+This function reserves room for `count` tokens in every array.
+</summary>*/
+void TokenStream::reserve(size_t count)
+{
+    kinds.reserve(count);
+    offsets.reserve(count);
+    lengths.reserve(count);
+    lines.reserve(count);
+    ids.reserve(count);
+}
+
+/* <summary>
+This function appends one token to the end of the stream; `lexemeHash` is `InternTable::hash(lexeme)`.
+</summary>*/
+void TokenStream::append(TokenKind kind, size_t offset, std::string_view lexeme, int line, uint32_t lexemeHash)
+{
+    kinds.push_back(kind);
+    offsets.push_back(static_cast<uint32_t>(offset));
+    lengths.push_back(static_cast<uint32_t>(lexeme.size()));
+    lines.push_back(static_cast<uint32_t>(line));
+    ids.push_back(shared ? internShared(lexeme, lexemeHash) : lexemes.intern(lexeme, lexemeHash));
+}
+
+/* <summary>
+This function makes the range `[first, last)` of one column `count` entries long, moving the entries behind it. The new entries are filled in by the caller.
+</summary>*/
+template <typename T>
+void TokenStream::resizeRange(std::vector<T>& column, size_t first, size_t last, size_t count)
+{
+    size_t oldCount = last - first;
+    if (count < oldCount)
+        column.erase(column.begin() + (first + count), column.begin() + last);
+    else if (count > oldCount)
+        column.insert(column.begin() + last, count - oldCount, T());
+}
+
+/* <summary>
+This function replaces the tokens `[first, last)` with all tokens of `replacement`, used by `Lexical::relex` to put a re-lexed range back into the stream and by `Lexical::scanParallel` to append the stream of a chunk (`first == last == size()`).
+
+Logic:
+1. Resize the range in every array; when the token count does not change, nothing behind it moves.
+2. Map the lexeme ids of `replacement` to ids of this stream. When both streams share one table, the ids are copied as they are. When `replacement` has its own table, every one of its lexemes is interned into this stream once, in id order, which is the order of first appearance in `replacement`; the tokens then only look their ids up in that remap. Otherwise (a different shared table) each token's lexeme is interned. Known lexemes keep their ids; ids of lexemes no longer used stay valid, the pool only grows.
+3. Copy the kinds and lengths, add `offsetBase` to the offsets and `lineBase` to the lines of `replacement`, and store the mapped ids.
+</summary>*/
+void TokenStream::splice(size_t first, size_t last, const TokenStream& replacement, size_t offsetBase, int lineBase)
+{
+    size_t count = replacement.size();
+    resizeRange(kinds, first, last, count);
+    resizeRange(offsets, first, last, count);
+    resizeRange(lengths, first, last, count);
+    resizeRange(lines, first, last, count);
+    resizeRange(ids, first, last, count);
+
+    std::vector<uint32_t> remap;
+    if (!replacement.shared)
+    {
+        remap.resize(replacement.lexemes.size());
+        for (uint32_t lexemeId = 0; lexemeId < remap.size(); ++lexemeId)
+        {
+            std::string_view lexeme = replacement.lexemes.text(lexemeId);
+            uint32_t lexemeHash = replacement.lexemes.hashOf(lexemeId);
+            remap[lexemeId] = shared ? internShared(lexeme, lexemeHash) : lexemes.intern(lexeme, lexemeHash);
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        kinds[first + i] = replacement.kinds[i];
+        offsets[first + i] = static_cast<uint32_t>(offsetBase + replacement.offsets[i]);
+        lengths[first + i] = replacement.lengths[i];
+        lines[first + i] = static_cast<uint32_t>(lineBase + static_cast<int>(replacement.lines[i]));
+        if (!replacement.shared)
+            ids[first + i] = remap[replacement.ids[i]];
+        else if (replacement.shared == shared)
+            ids[first + i] = replacement.ids[i];
+        else
+            ids[first + i] = shared ? internShared(replacement.lexeme(i), replacement.hash(replacement.ids[i]))
+                                    : lexemes.intern(replacement.lexeme(i), replacement.hash(replacement.ids[i]));
+    }
+}
+
+/* <summary>
+This function moves the tokens from `first` to the end by `offsetDelta` bytes and `lineDelta` lines, after text before them was inserted or removed.
+</summary>*/
+void TokenStream::shift(size_t first, long long offsetDelta, int lineDelta)
+{
+    const uint32_t offsetStep = static_cast<uint32_t>(offsetDelta);
+    const uint32_t lineStep = static_cast<uint32_t>(lineDelta);
+    for (size_t i = first; i < offsets.size(); ++i)
+    {
+        offsets[i] += offsetStep;
+        lines[i] += lineStep;
+    }
+}
+
+#endif // TOKEN_STREAM_H